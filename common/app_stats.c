@@ -0,0 +1,262 @@
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/sys/byteorder.h>
+#include <errno.h>
+#include <string.h>
+
+#include "app_stats.h"
+
+#define DUMP_VERSION 2
+#define BENCH_N      10000
+
+/* ===================== Registry ===================== */
+void app_stats_reset(void)
+{
+    STRUCT_SECTION_FOREACH(app_stat, s) {
+        atomic_clear(&s->value);
+        if (s->hist) {
+            for (int i = 0; i < APP_STAT_HIST_BUCKETS; i++) atomic_clear(&s->hist->bucket[i]);
+            atomic_clear(&s->hist->sum_lo);
+            atomic_clear(&s->hist->sum_hi);
+            atomic_clear(&s->hist->max);
+        }
+    }
+}
+
+uint64_t app_stat_hist_sum(const struct app_stat *s)
+{
+    uint32_t hi, lo;
+
+    do {
+        hi = (uint32_t)atomic_get(&s->hist->sum_hi);
+        lo = (uint32_t)atomic_get(&s->hist->sum_lo);
+    } while (hi != (uint32_t)atomic_get(&s->hist->sum_hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+static uint8_t *put32(uint8_t *p, uint32_t v)
+{
+    sys_put_le32(v, p);
+    return p + 4;
+}
+
+size_t app_stats_dump(uint8_t *buf, size_t len)
+{
+    size_t need = 12;
+    uint16_t count = 0;
+
+    STRUCT_SECTION_FOREACH(app_stat, s) {
+        need += 2 + strlen(s->name) + 4;
+        if (s->type == APP_STAT_HIST) need += 12 + 4 * APP_STAT_HIST_BUCKETS;
+        count++;
+    }
+    if (need > len) return need;
+
+    uint8_t *p = buf;
+    memcpy(p, "ASTD", 4);
+    p[4] = DUMP_VERSION;
+    p[5] = 0;
+    sys_put_le16(count, &p[6]);
+    p = put32(p + 8, k_uptime_get_32());
+
+    STRUCT_SECTION_FOREACH(app_stat, s) {
+        size_t n = strlen(s->name);
+
+        *p++ = s->type;
+        *p++ = (uint8_t)n;
+        memcpy(p, s->name, n);
+        p = put32(p + n, (uint32_t)atomic_get(&s->value));
+
+        if (s->type == APP_STAT_HIST) {
+            sys_put_le64(app_stat_hist_sum(s), p);
+            p = put32(p + 8, (uint32_t)atomic_get(&s->hist->max));
+            for (int i = 0; i < APP_STAT_HIST_BUCKETS; i++) {
+                p = put32(p, (uint32_t)atomic_get(&s->hist->bucket[i]));
+            }
+        }
+    }
+    return need;
+}
+
+/* ===================== Bench ===================== */
+const char *const app_stats_bench_name[APP_STATS_BENCH_OPS] = {
+    "counter inc", "max update", "hist record", "timed hist",
+};
+
+/* spread over every bucket, so the histogram cost is not one hot line */
+static inline uint32_t bench_value(int i)
+{
+    return ((uint32_t)i * 2654435761u) >> (i & 31);
+}
+
+void app_stats_bench(uint32_t ns_x10[APP_STATS_BENCH_OPS])
+{
+    /* private statistics outside the registry */
+    static struct app_stat_hist h, th;
+    static struct app_stat ctr = { .type = APP_STAT_COUNTER };
+    static struct app_stat max = { .type = APP_STAT_MAX };
+    static struct app_stat hist = { .type = APP_STAT_HIST, .hist = &h };
+    static struct app_stat timed = { .type = APP_STAT_HIST, .hist = &th };
+    uint32_t t[APP_STATS_BENCH_OPS + 2];
+
+    /* from zero each run: every max update is a new maximum */
+    memset(&h, 0, sizeof(h));
+    memset(&th, 0, sizeof(th));
+    atomic_clear(&ctr.value);
+    atomic_clear(&max.value);
+    atomic_clear(&hist.value);
+    atomic_clear(&timed.value);
+
+    unsigned int key = irq_lock();
+    uint32_t last = k_cycle_get_32();
+
+    t[0] = k_cycle_get_32();
+    for (int i = 0; i < BENCH_N; i++) __asm__ volatile("");
+    t[1] = k_cycle_get_32();
+    for (int i = 0; i < BENCH_N; i++) app_stat_inc(&ctr);
+    t[2] = k_cycle_get_32();
+    for (int i = 0; i < BENCH_N; i++) app_stat_max(&max, (uint32_t)i);
+    t[3] = k_cycle_get_32();
+    for (int i = 0; i < BENCH_N; i++) app_stat_hist_record(&hist, bench_value(i));
+    t[4] = k_cycle_get_32();
+    for (int i = 0; i < BENCH_N; i++) {
+        uint32_t now = k_cycle_get_32();
+        app_stat_hist_record(&timed, k_cyc_to_us_floor32(now - last));
+        last = now;
+    }
+    t[5] = k_cycle_get_32();
+    irq_unlock(key);
+
+    uint32_t loop = t[1] - t[0];
+
+    for (int i = 0; i < APP_STATS_BENCH_OPS; i++) {
+        uint32_t cyc = t[i + 2] - t[i + 1];
+        uint32_t net = cyc > loop ? cyc - loop : 0;
+
+        ns_x10[i] = (uint32_t)(k_cyc_to_ns_floor64(net) * 10 / BENCH_N);
+    }
+}
+
+/* ===================== Shell ===================== */
+static void show_hist(const struct shell *sh, const struct app_stat *s)
+{
+    uint32_t n = (uint32_t)atomic_get(&s->value);
+    uint64_t sum = app_stat_hist_sum(s);
+
+    shell_print(sh, "%-28s n %u avg %u max %u %s", s->name, n, n ? (uint32_t)(sum / n) : 0,
+                (uint32_t)atomic_get(&s->hist->max), s->unit);
+
+    /* only the populated range: "<2^i: count" */
+    for (int i = 0; i < APP_STAT_HIST_BUCKETS; i++) {
+        uint32_t c = (uint32_t)atomic_get(&s->hist->bucket[i]);
+        if (!c) continue;
+        if (i == APP_STAT_HIST_BUCKETS - 1) {
+            shell_print(sh, "  %28s>=%u: %u", "", 1u << (i - 1), c);
+        } else {
+            shell_print(sh, "  %28s<%u: %u", "", 1u << i, c);
+        }
+    }
+}
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+static void show_thread(const struct k_thread *t, void *user_data)
+{
+    const struct shell *sh = user_data;
+    k_thread_runtime_stats_t rt, all;
+    const char *name = k_thread_name_get((k_tid_t)t);
+
+    if (k_thread_runtime_stats_get((k_tid_t)t, &rt) != 0 ||
+        k_thread_runtime_stats_all_get(&all) != 0 || all.execution_cycles == 0) {
+        return;
+    }
+    uint32_t permille = (uint32_t)(rt.execution_cycles * 1000 / all.execution_cycles);
+    shell_print(sh, "thread %-21s %u.%u %% cpu", name ? name : "?", permille / 10, permille % 10);
+}
+#endif
+
+static int cmd_show(const struct shell *sh, size_t argc, char **argv)
+{
+    const char *prefix = argc > 1 ? argv[1] : "";
+
+    STRUCT_SECTION_FOREACH(app_stat, s) {
+        if (strncmp(s->name, prefix, strlen(prefix)) != 0) continue;
+
+        switch (s->type) {
+        case APP_STAT_COUNTER:
+            shell_print(sh, "%-28s %u", s->name, (uint32_t)atomic_get(&s->value));
+            break;
+        case APP_STAT_MAX:
+            shell_print(sh, "%-28s max %u %s", s->name, (uint32_t)atomic_get(&s->value), s->unit);
+            break;
+        case APP_STAT_HIST:
+            show_hist(sh, s);
+            break;
+        }
+    }
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+    if (argc == 1) k_thread_foreach(show_thread, (void *)sh);
+#endif
+    return 0;
+}
+
+static int cmd_reset(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    app_stats_reset();
+    shell_print(sh, "statistics cleared");
+    return 0;
+}
+
+static int cmd_dump(const struct shell *sh, size_t argc, char **argv)
+{
+    static uint8_t buf[CONFIG_APP_STATS_DUMP_SIZE];
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    size_t n = app_stats_dump(buf, sizeof(buf));
+    if (n > sizeof(buf)) {
+        shell_error(sh, "need %u bytes, raise CONFIG_APP_STATS_DUMP_SIZE", (unsigned)n);
+        return -ENOMEM;
+    }
+
+    /* hex, 32 bytes per line, so it survives the shell transport */
+    char line[65];
+    for (size_t off = 0; off < n; off += 32) {
+        size_t k = MIN(n - off, 32);
+        for (size_t i = 0; i < k; i++) {
+            static const char hex[] = "0123456789abcdef";
+            line[2 * i] = hex[buf[off + i] >> 4];
+            line[2 * i + 1] = hex[buf[off + i] & 0xF];
+        }
+        line[2 * k] = '\0';
+        shell_print(sh, "%s", line);
+    }
+    return 0;
+}
+
+static int cmd_bench(const struct shell *sh, size_t argc, char **argv)
+{
+    uint32_t ns_x10[APP_STATS_BENCH_OPS];
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    app_stats_bench(ns_x10);
+    for (int i = 0; i < APP_STATS_BENCH_OPS; i++) {
+        shell_print(sh, "%-12s %u.%u ns per update", app_stats_bench_name[i],
+                    ns_x10[i] / 10, ns_x10[i] % 10);
+    }
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_stats,
+    SHELL_CMD_ARG(show, NULL, "Print statistics [name prefix]", cmd_show, 1, 1),
+    SHELL_CMD(reset, NULL, "Zero all statistics", cmd_reset),
+    SHELL_CMD(dump, NULL, "Binary snapshot, hex encoded", cmd_dump),
+    SHELL_CMD(bench, NULL, "Measure the cost of each update type", cmd_bench),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(stats, &sub_stats, "Application statistics", NULL);
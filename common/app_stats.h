@@ -0,0 +1,153 @@
+#ifndef APP_STATS_H
+#define APP_STATS_H
+
+/*
+ * Statistics registry for the Zephyr labs.
+ *
+ * Every statistic is a statically defined struct app_stat placed in an
+ * iterable section, so defining one is all the registration there is.
+ * Updates are single atomic operations (a CAS loop for maxima, a few
+ * atomics for a histogram sample) and safe from ISRs.
+ *
+ *   APP_STAT_COUNTER_DEFINE(var, name)        events, bytes, errors
+ *   APP_STAT_MAX_DEFINE(var, name, unit)      high-water marks
+ *   APP_STAT_HIST_DEFINE(var, name, unit)     log2 histogram + count/sum/max
+ *
+ * Shell: "stats show [prefix]", "stats reset", "stats dump" (binary
+ * snapshot, hex encoded), "stats bench" (cost of each update type).
+ *
+ * Without CONFIG_APP_STATS the definitions are unused objects and every
+ * update compiles to nothing.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define APP_STAT_HIST_BUCKETS 32   // bucket i: values in [2^(i-1), 2^i), bucket 0: 0
+
+enum app_stat_type {
+    APP_STAT_COUNTER,
+    APP_STAT_MAX,
+    APP_STAT_HIST,
+};
+
+#ifdef CONFIG_APP_STATS
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/iterable_sections.h>
+#include <zephyr/sys/util.h>
+
+struct app_stat_hist {
+    atomic_t bucket[APP_STAT_HIST_BUCKETS];
+    atomic_t sum_lo;            // 64-bit sum, carried by hand: us-scale
+    atomic_t sum_hi;            //   periods pass 2^32 within hours
+    atomic_t max;
+};
+
+struct app_stat {
+    const char *name;
+    const char *unit;
+    uint8_t type;               // enum app_stat_type
+    atomic_t value;             // counter, maximum, or histogram sample count
+    struct app_stat_hist *hist;
+};
+
+#define APP_STAT_COUNTER_DEFINE(_var, _name) \
+    STRUCT_SECTION_ITERABLE(app_stat, _var) = { .name = _name, .unit = "", .type = APP_STAT_COUNTER }
+
+#define APP_STAT_MAX_DEFINE(_var, _name, _unit) \
+    STRUCT_SECTION_ITERABLE(app_stat, _var) = { .name = _name, .unit = _unit, .type = APP_STAT_MAX }
+
+#define APP_STAT_HIST_DEFINE(_var, _name, _unit)                                           \
+    static struct app_stat_hist _var##_hist;                                               \
+    STRUCT_SECTION_ITERABLE(app_stat, _var) = {                                            \
+        .name = _name, .unit = _unit, .type = APP_STAT_HIST, .hist = &_var##_hist }
+
+static inline void app_stat_inc(struct app_stat *s)
+{
+    (void)atomic_inc(&s->value);
+}
+
+static inline void app_stat_add(struct app_stat *s, uint32_t n)
+{
+    (void)atomic_add(&s->value, (atomic_val_t)n);
+}
+
+static inline void app_stat_max_cas(atomic_t *a, uint32_t v)
+{
+    atomic_val_t old;
+
+    do {
+        old = atomic_get(a);
+        if ((uint32_t)old >= v) return;
+    } while (!atomic_cas(a, old, (atomic_val_t)v));
+}
+
+static inline void app_stat_max(struct app_stat *s, uint32_t v)
+{
+    app_stat_max_cas(&s->value, v);
+}
+
+static inline void app_stat_hist_record(struct app_stat *s, uint32_t v)
+{
+    uint32_t b = v ? 32 - __builtin_clz(v) : 0;
+
+    (void)atomic_inc(&s->hist->bucket[MIN(b, APP_STAT_HIST_BUCKETS - 1)]);
+
+    uint32_t lo = (uint32_t)atomic_add(&s->hist->sum_lo, (atomic_val_t)v);
+    if (lo + v < lo) (void)atomic_inc(&s->hist->sum_hi);
+
+    (void)atomic_inc(&s->value);
+    app_stat_max_cas(&s->hist->max, v);
+}
+
+/* histogram sum; off by 2^32 while a carry is in flight */
+uint64_t app_stat_hist_sum(const struct app_stat *s);
+
+/* zero every statistic */
+void app_stats_reset(void);
+
+/*
+ * Binary snapshot of every statistic, little endian:
+ *   "ASTD", u8 version (2), u8 reserved, u16 entry count, u32 uptime ms
+ *   per entry: u8 type, u8 name length, name bytes, u32 value, and for
+ *   histograms u64 sum, u32 max, u32 bucket[APP_STAT_HIST_BUCKETS]
+ * Returns the bytes needed; only writes if they fit in len.
+ */
+size_t app_stats_dump(uint8_t *buf, size_t len);
+
+/* what "stats bench" times: each update type, and a timed histogram
+   sample as the instrumented code records it (cycle read, conversion
+   to us, record) */
+enum app_stats_bench_op {
+    APP_STATS_BENCH_INC,
+    APP_STATS_BENCH_MAX,
+    APP_STATS_BENCH_HIST,
+    APP_STATS_BENCH_TIMED_HIST,
+    APP_STATS_BENCH_OPS,
+};
+
+extern const char *const app_stats_bench_name[APP_STATS_BENCH_OPS];
+
+/* cost per update in 0.1 ns, on private statistics, with IRQs locked */
+void app_stats_bench(uint32_t ns_x10[APP_STATS_BENCH_OPS]);
+
+#else /* !CONFIG_APP_STATS */
+
+struct app_stat {
+    uint8_t unused;
+};
+
+#define APP_STAT_COUNTER_DEFINE(_var, _name)     static struct app_stat _var __attribute__((unused))
+#define APP_STAT_MAX_DEFINE(_var, _name, _unit)  static struct app_stat _var __attribute__((unused))
+#define APP_STAT_HIST_DEFINE(_var, _name, _unit) static struct app_stat _var __attribute__((unused))
+
+static inline void app_stat_inc(struct app_stat *s) { (void)s; }
+static inline void app_stat_add(struct app_stat *s, uint32_t n) { (void)s; (void)n; }
+static inline void app_stat_max(struct app_stat *s, uint32_t v) { (void)s; (void)v; }
+static inline void app_stat_hist_record(struct app_stat *s, uint32_t v) { (void)s; (void)v; }
+
+#endif /* CONFIG_APP_STATS */
+
+#endif /* APP_STATS_H */
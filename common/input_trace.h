@@ -0,0 +1,146 @@
+#ifndef INPUT_TRACE_H
+#define INPUT_TRACE_H
+
+/*
+ * Compact binary trace of timestamped GPIO edges.
+ *
+ * Shared by the on-device capture mode (lab1, lab2/part2) and the host
+ * replay engine (tools/replay). Header only so it builds unchanged with
+ * the Pico SDK, Zephyr and a plain host compiler.
+ *
+ * File layout:
+ *   header : "ITRC" + version byte + 3 reserved bytes
+ *   record : ULEB128 delta time in us since the previous record,
+ *            followed by one byte = pin[5:0] | rising << 7
+ *   drop   : a record with pin INPUT_TRACE_PIN_DROP, followed by the
+ *            ULEB128 count of edges the capture lost before it
+ *   output : a record with pin INPUT_TRACE_PIN_OUTPUT, followed by one
+ *            byte of device output state (LED levels, INPUT_TRACE_OUT_PWM);
+ *            one per main-loop pass, stamped when that pass fetched its
+ *            events, so a host replay can run in lockstep with the device
+ *
+ * A button edge every few ms costs 2-3 bytes.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define INPUT_TRACE_VERSION     3
+#define INPUT_TRACE_HEADER_LEN  8
+#define INPUT_TRACE_RECORD_MAX  11  // varint + pin byte + varint drop count
+
+#define INPUT_TRACE_PIN_MASK    0x3f
+#define INPUT_TRACE_PIN_DROP    0x3f    // not an edge: a drop count follows
+#define INPUT_TRACE_PIN_OUTPUT  0x3e    // not an edge: an output byte follows
+#define INPUT_TRACE_RISING      0x80
+
+/* output byte: bit n = LED n lit as a plain GPIO, plus */
+#define INPUT_TRACE_OUT_PWM     0x80    // an LED driven by PWM
+
+/* One decoded edge, absolute time */
+struct input_edge {
+    uint64_t t_us;
+    uint8_t  pin;
+    bool     rising;
+};
+
+static inline size_t input_trace_header(uint8_t *out)
+{
+    out[0] = 'I'; out[1] = 'T'; out[2] = 'R'; out[3] = 'C';
+    out[4] = INPUT_TRACE_VERSION;
+    out[5] = 0; out[6] = 0; out[7] = 0;
+    return INPUT_TRACE_HEADER_LEN;
+}
+
+static inline bool input_trace_header_ok(const uint8_t *in, size_t len)
+{
+    return len >= INPUT_TRACE_HEADER_LEN &&
+           in[0] == 'I' && in[1] == 'T' && in[2] == 'R' && in[3] == 'C' &&
+           in[4] == INPUT_TRACE_VERSION;
+}
+
+static inline size_t input_trace_varint(uint8_t *out, uint32_t v)
+{
+    size_t n = 0;
+    do {
+        uint8_t b = v & 0x7f;
+        v >>= 7;
+        out[n++] = b | (v ? 0x80 : 0);
+    } while (v);
+    return n;
+}
+
+/* Encode one edge; returns bytes written (at most INPUT_TRACE_RECORD_MAX) */
+static inline size_t input_trace_encode(uint8_t *out, uint32_t delta_us,
+                                        uint8_t pin, bool rising)
+{
+    size_t n = input_trace_varint(out, delta_us);
+
+    out[n++] = (pin & INPUT_TRACE_PIN_MASK) | (rising ? INPUT_TRACE_RISING : 0);
+    return n;
+}
+
+/* Encode a marker for `count` lost edges; returns bytes written */
+static inline size_t input_trace_encode_drop(uint8_t *out, uint32_t delta_us, uint32_t count)
+{
+    size_t n = input_trace_varint(out, delta_us);
+
+    out[n++] = INPUT_TRACE_PIN_DROP;
+    return n + input_trace_varint(out + n, count);
+}
+
+/* Encode one output frame; returns bytes written */
+static inline size_t input_trace_encode_output(uint8_t *out, uint32_t delta_us, uint8_t outputs)
+{
+    size_t n = input_trace_varint(out, delta_us);
+
+    out[n++] = INPUT_TRACE_PIN_OUTPUT;
+    out[n++] = outputs;
+    return n;
+}
+
+static inline size_t input_trace_get_varint(const uint8_t *in, size_t len, uint32_t *v)
+{
+    size_t n = 0;
+    unsigned shift = 0;
+
+    *v = 0;
+    while (n < len && shift < 35) {
+        uint8_t b = in[n++];
+        *v |= (uint32_t)(b & 0x7f) << shift;
+        shift += 7;
+        if (!(b & 0x80)) return n;
+    }
+    return 0;
+}
+
+/*
+ * Decode one record at in[0..len); returns bytes consumed, 0 on truncation.
+ * *value is 0 for an edge, the lost edge count for a drop marker (*pin
+ * INPUT_TRACE_PIN_DROP) and the output byte for an output frame (*pin
+ * INPUT_TRACE_PIN_OUTPUT).
+ */
+static inline size_t input_trace_decode(const uint8_t *in, size_t len, uint32_t *delta_us,
+                                        uint8_t *pin, bool *rising, uint32_t *value)
+{
+    size_t n = input_trace_get_varint(in, len, delta_us);
+
+    if (n == 0 || n >= len) return 0;
+    *pin    = in[n] & INPUT_TRACE_PIN_MASK;
+    *rising = (in[n] & INPUT_TRACE_RISING) != 0;
+    *value  = 0;
+    n++;
+
+    if (*pin == INPUT_TRACE_PIN_DROP) {
+        size_t m = input_trace_get_varint(in + n, len - n, value);
+        if (m == 0) return 0;
+        n += m;
+    } else if (*pin == INPUT_TRACE_PIN_OUTPUT) {
+        if (n >= len) return 0;
+        *value = in[n++];
+    }
+    return n;
+}
+
+#endif /* INPUT_TRACE_H */
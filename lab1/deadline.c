@@ -0,0 +1,54 @@
+#include "pico/stdlib.h"
+#include "hardware/irq.h"
+#include "hardware/timer.h"
+
+#include "deadline.h"
+#include "hot_path.h"
+
+/* Register-level on purpose: the SDK alarm calls live in flash and are
+   reached from the button ISR, which may be in the SRAM hot path */
+static uint alarm_num;
+static deadline_cb_t callback;
+
+static void HOT_FUNC(deadline_isr)(void)
+{
+    uint32_t bit = 1u << alarm_num;
+
+    hw_clear_bits(&timer_hw->intf, bit);    // set by deadline_set() for a past target
+    timer_hw->intr = bit;
+    callback(time_us_32());
+}
+
+void deadline_init(deadline_cb_t cb)
+{
+    callback = cb;
+    alarm_num = (uint)hardware_alarm_claim_unused(true);
+
+    uint irq = hardware_alarm_get_irq_num(alarm_num);
+    irq_set_exclusive_handler(irq, deadline_isr);
+    hw_set_bits(&timer_hw->inte, 1u << alarm_num);
+    irq_set_enabled(irq, true);
+}
+
+void HOT_FUNC(deadline_set)(uint32_t t_us)
+{
+    uint32_t bit = 1u << alarm_num;
+
+    timer_hw->alarm[alarm_num] = t_us;      // writing the target arms it
+
+    /* the compare only matches on equality: a passed target would wait
+       for the counter to wrap, so raise the IRQ by hand */
+    if ((int32_t)(t_us - time_us_32()) <= 0) {
+        hw_set_bits(&timer_hw->intf, bit);
+    }
+}
+
+void HOT_FUNC(deadline_cancel)(void)
+{
+    timer_hw->armed = 1u << alarm_num;      // write 1 to disarm
+}
+
+unsigned deadline_irq_num(void)
+{
+    return hardware_alarm_get_irq_num(alarm_num);
+}
@@ -0,0 +1,26 @@
+#ifndef DEADLINE_H
+#define DEADLINE_H
+
+/*
+ * One-shot deadline on a hardware timer alarm, for code that should sleep
+ * until its next timeout instead of polling. One deadline pending at a
+ * time; setting a new one replaces it. The callback runs in the alarm
+ * IRQ, at the same priority as the GPIO IRQ, so the two never preempt
+ * each other.
+ */
+
+#include <stdint.h>
+
+typedef void (*deadline_cb_t)(uint32_t now_us);
+
+void deadline_init(deadline_cb_t cb);
+
+/* fire at t_us (time_us_32() scale); at once if already past */
+void deadline_set(uint32_t t_us);
+
+void deadline_cancel(void);
+
+/* the alarm IRQ, to keep its priority equal to the GPIO IRQ's */
+unsigned deadline_irq_num(void);
+
+#endif /* DEADLINE_H */
@@ -0,0 +1,94 @@
+#include <string.h>
+
+#include "event_queue.h"
+#include "hot_path.h"
+
+/* plain loops rather than memmove: evq_post runs in the ISR, and the
+   library copy would fetch from flash even with the hot path in SRAM
+   (the hot_path build also stops GCC turning the loops back into calls) */
+static void HOT_FUNC(remove_at)(evq_t *q, uint8_t i)
+{
+    for (uint8_t j = i; j + 1 < q->count; j++) {
+        q->entries[j] = q->entries[j + 1];
+    }
+    q->count--;
+}
+
+static uint8_t HOT_FUNC(prio_of)(const evq_t *q, uint8_t type)
+{
+    return q->policy[type].prio;
+}
+
+void evq_init(evq_t *q, const evq_policy_t *policy, uint8_t n_types)
+{
+    memset(q, 0, sizeof(*q));
+    q->policy = policy;
+    q->n_types = n_types;
+}
+
+bool HOT_FUNC(evq_post)(evq_t *q, uint8_t type, uint32_t t_ms)
+{
+    if (type >= q->n_types) return false;
+
+    const evq_policy_t *p = &q->policy[type];
+    q->stats.posted++;
+
+    /* a preempting event makes every lower-class one stale */
+    if (p->flags & EVQ_PREEMPT) {
+        for (uint8_t i = 0; i < q->count;) {
+            if (prio_of(q, q->entries[i].type) < p->prio) {
+                remove_at(q, i);
+                q->stats.preempted++;
+            } else {
+                i++;
+            }
+        }
+    }
+
+    /* latest wins: drop the pending one, the new one goes to the back */
+    if (p->flags & EVQ_COALESCE) {
+        for (uint8_t i = 0; i < q->count; i++) {
+            if (q->entries[i].type == type) {
+                remove_at(q, i);
+                q->stats.coalesced++;
+                break;
+            }
+        }
+    }
+
+    if (q->count == EVQ_CAPACITY) {
+        /* evict the oldest entry of the lowest class, if it does not outrank us */
+        uint8_t victim = 0;
+        for (uint8_t i = 1; i < q->count; i++) {
+            if (prio_of(q, q->entries[i].type) < prio_of(q, q->entries[victim].type)) victim = i;
+        }
+        q->stats.overflow++;
+        if (prio_of(q, q->entries[victim].type) > p->prio) return false;
+        remove_at(q, victim);
+    }
+
+    q->entries[q->count].type = type;
+    q->entries[q->count].t_ms = t_ms;
+    q->count++;
+    if (q->count > q->stats.max_depth) q->stats.max_depth = q->count;
+    return true;
+}
+
+size_t HOT_FUNC(evq_take_all)(evq_t *q, evq_entry_t *out, size_t max)
+{
+    size_t n = q->count < max ? q->count : max;
+
+    if (n == 0) return 0;
+
+    for (size_t i = 0; i < n; i++) {
+        out[i] = q->entries[i];
+    }
+    q->count -= (uint8_t)n;
+    for (size_t i = 0; i < q->count; i++) {
+        q->entries[i] = q->entries[i + n];
+    }
+
+    q->stats.delivered += (uint32_t)n;
+    q->stats.batches++;
+    return n;
+}
@@ -0,0 +1,64 @@
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+
+/*
+ * Event queue between the button ISR (evq_post) and the FSM loop
+ * (evq_take_all), with a policy per event type:
+ *
+ *  - EVQ_COALESCE: a new event replaces a pending one of the same type
+ *    and moves to the back, so the latest press wins.
+ *  - prio / EVQ_PREEMPT: a preempting event drops every pending event of
+ *    a lower class. When the queue is full, the oldest event of the
+ *    lowest class not above the new one makes room; if every pending
+ *    event outranks it, the new one is dropped.
+ *
+ * Delivery is in arrival order. Plain C with no locking: the consumer
+ * masks the producer's interrupt around evq_take_all().
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define EVQ_CAPACITY 16
+
+#define EVQ_COALESCE 0x01
+#define EVQ_PREEMPT  0x02
+
+typedef struct _evq_policy_t {
+    uint8_t prio;       // class, higher outranks lower
+    uint8_t flags;      // EVQ_COALESCE | EVQ_PREEMPT
+} evq_policy_t;
+
+typedef struct _evq_entry_t {
+    uint8_t type;
+    uint32_t t_ms;      // when it was posted
+} evq_entry_t;
+
+typedef struct _evq_stats_t {
+    uint32_t posted;
+    uint32_t delivered;
+    uint32_t coalesced;     // replaced by a newer one of the same type
+    uint32_t preempted;     // dropped by a higher-class EVQ_PREEMPT event
+    uint32_t overflow;      // dropped because the queue was full
+    uint32_t batches;       // evq_take_all() calls that returned events
+    uint8_t max_depth;
+} evq_stats_t;
+
+typedef struct _evq_t {
+    const evq_policy_t *policy;     // indexed by type
+    uint8_t n_types;
+    uint8_t count;
+    evq_entry_t entries[EVQ_CAPACITY];
+    evq_stats_t stats;
+} evq_t;
+
+void evq_init(evq_t *q, const evq_policy_t *policy, uint8_t n_types);
+
+/* ISR side; false if the event was dropped */
+bool evq_post(evq_t *q, uint8_t type, uint32_t t_ms);
+
+/* move up to max pending events, oldest first, into out; returns the count */
+size_t evq_take_all(evq_t *q, evq_entry_t *out, size_t max);
+
+#endif /* EVENT_QUEUE_H */
@@ -0,0 +1,214 @@
+#include <string.h>
+
+#include "gesture.h"
+#include "hot_path.h"
+
+enum {
+    GST_IDLE = 0,
+    GST_DOWN,       // pressed, gesture not decided yet
+    GST_WAIT2,      // clicked once, double-click window open
+    GST_HELD,       // decided; nothing more until release
+};
+
+/* times wrap with the 32-bit us counter */
+static inline bool due(uint32_t deadline, uint32_t now)
+{
+    return (int32_t)(now - deadline) >= 0;
+}
+
+static inline bool earlier(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b) < 0;
+}
+
+static void HOT_FUNC(emit)(gesture_t *g, gesture_kind_t kind, uint8_t buttons, uint32_t t_us)
+{
+    g->stats.emitted++;
+    g->emit(g->ctx, kind, buttons, t_us);
+}
+
+/* other chord members still undecided and pressed within the window */
+static uint8_t HOT_FUNC(chord_partners)(const gesture_t *g, uint8_t button, uint32_t t_us)
+{
+    uint8_t mask = 0;
+
+    for (uint8_t i = 0; i < g->n_buttons; i++) {
+        const gesture_button_t *b = &g->buttons[i];
+        if (i != button && (b->flags & GESTURE_CHORD) && b->state == GST_DOWN &&
+            t_us - b->t_us <= g->timing.chord_us) {
+            mask |= (uint8_t)(1u << i);
+        }
+    }
+    return mask;
+}
+
+static void HOT_FUNC(on_press)(gesture_t *g, uint8_t button, uint32_t t_us)
+{
+    gesture_button_t *b = &g->buttons[button];
+    uint8_t partners;
+
+    if (b->flags == 0) {
+        b->state = GST_HELD;
+        emit(g, GESTURE_PRESS, (uint8_t)(1u << button), t_us);
+    } else if (b->state == GST_WAIT2) {
+        b->state = GST_HELD;
+        emit(g, GESTURE_DOUBLE_CLICK, (uint8_t)(1u << button), t_us);
+    } else if ((b->flags & GESTURE_CHORD) && (partners = chord_partners(g, button, t_us)) != 0) {
+        for (uint8_t i = 0; i < g->n_buttons; i++) {
+            if (partners & (1u << i)) g->buttons[i].state = GST_HELD;
+        }
+        b->state = GST_HELD;
+        emit(g, GESTURE_CHORD_PRESS, (uint8_t)(partners | (1u << button)), t_us);
+    } else {
+        b->state = GST_DOWN;
+    }
+}
+
+static void HOT_FUNC(on_release)(gesture_t *g, uint8_t button, uint32_t t_us)
+{
+    gesture_button_t *b = &g->buttons[button];
+
+    if (b->state == GST_DOWN && (b->flags & GESTURE_DOUBLE)) {
+        b->state = GST_WAIT2;
+    } else if (b->state == GST_DOWN) {
+        b->state = GST_IDLE;
+        emit(g, GESTURE_CLICK, (uint8_t)(1u << button), t_us);
+    } else {
+        b->state = GST_IDLE;
+    }
+}
+
+/* a debounced edge: start the lockout and step the gesture */
+static void HOT_FUNC(accept)(gesture_t *g, uint8_t button, bool pressed, uint32_t t_us)
+{
+    gesture_button_t *b = &g->buttons[button];
+
+    b->down = pressed;
+    b->settling = true;
+    b->settle_us = t_us + g->timing.debounce_us;
+    b->t_us = t_us;
+
+    if (pressed) on_press(g, button, t_us);
+    else         on_release(g, button, t_us);
+}
+
+/* earliest deadline of one button; false if it has none */
+static bool HOT_FUNC(button_deadline)(const gesture_t *g, const gesture_button_t *b, uint32_t *t_us)
+{
+    bool any = false;
+    uint32_t t = 0;
+
+    /* the lockout only needs a wakeup if it hides a change */
+    if (b->settling && b->raw != b->down) {
+        t = b->settle_us;
+        any = true;
+    }
+
+    uint32_t timeout;
+    if (b->state == GST_DOWN && (b->flags & GESTURE_LONG)) {
+        timeout = b->t_us + g->timing.long_us;
+    } else if (b->state == GST_WAIT2) {
+        timeout = b->t_us + g->timing.double_us;
+    } else {
+        *t_us = t;
+        return any;
+    }
+
+    *t_us = (!any || earlier(timeout, t)) ? timeout : t;
+    return true;
+}
+
+void gesture_init(gesture_t *g, const uint8_t *flags, uint8_t n_buttons,
+                  const gesture_timing_t *timing, gesture_emit_t emit, void *ctx)
+{
+    memset(g, 0, sizeof(*g));
+    g->timing = *timing;
+    g->emit = emit;
+    g->ctx = ctx;
+    g->n_buttons = n_buttons < GESTURE_MAX_BUTTONS ? n_buttons : GESTURE_MAX_BUTTONS;
+
+    for (uint8_t i = 0; i < g->n_buttons; i++) {
+        g->buttons[i].flags = flags[i];
+    }
+}
+
+bool HOT_FUNC(gesture_next_deadline)(const gesture_t *g, uint32_t *t_us)
+{
+    bool any = false;
+
+    for (uint8_t i = 0; i < g->n_buttons; i++) {
+        uint32_t t;
+        if (button_deadline(g, &g->buttons[i], &t) && (!any || earlier(t, *t_us))) {
+            *t_us = t;
+            any = true;
+        }
+    }
+    return any;
+}
+
+/* every deadline due at t_us, each handled at its own time */
+static void HOT_FUNC(expire_at)(gesture_t *g, uint32_t t_us)
+{
+    for (uint8_t i = 0; i < g->n_buttons; i++) {
+        gesture_button_t *b = &g->buttons[i];
+
+        /* an edge bounced back during the lockout: take the level it settled at */
+        if (b->settling && due(b->settle_us, t_us)) {
+            b->settling = false;
+            if (b->raw != b->down) accept(g, i, b->raw, b->settle_us);
+        }
+
+        /* timeouts are reported at their deadline, however late the wakeup */
+        if (b->state == GST_DOWN && (b->flags & GESTURE_LONG) &&
+            due(b->t_us + g->timing.long_us, t_us)) {
+            b->state = GST_HELD;
+            emit(g, GESTURE_LONG_PRESS, (uint8_t)(1u << i), b->t_us + g->timing.long_us);
+        } else if (b->state == GST_WAIT2 && due(b->t_us + g->timing.double_us, t_us)) {
+            b->state = GST_IDLE;
+            emit(g, GESTURE_CLICK, (uint8_t)(1u << i), b->t_us + g->timing.double_us);
+        }
+    }
+}
+
+/* in time order, so each sees the state the earlier ones left */
+static void HOT_FUNC(expire_until)(gesture_t *g, uint32_t now_us)
+{
+    uint32_t t;
+
+    while (gesture_next_deadline(g, &t) && due(t, now_us)) {
+        expire_at(g, t);
+    }
+}
+
+void HOT_FUNC(gesture_edge)(gesture_t *g, uint8_t button, bool pressed, uint32_t t_us)
+{
+    if (button >= g->n_buttons) return;
+
+    /* deadlines up to the edge come first, whether or not the alarm has
+       run yet: a press after the double-click window is not a double,
+       a release after the long-press time not a click */
+    expire_until(g, t_us);
+
+    gesture_button_t *b = &g->buttons[button];
+    b->raw = pressed;
+    g->stats.edges++;
+
+    /* inside the lockout: the deadline at its end sorts it out */
+    if (b->settling && !due(b->settle_us, t_us)) {
+        g->stats.bounces++;
+        return;
+    }
+    b->settling = false;
+
+    if (pressed == b->down) {
+        g->stats.bounces++;
+        return;
+    }
+    accept(g, button, pressed, t_us);
+}
+
+void HOT_FUNC(gesture_expire)(gesture_t *g, uint32_t now_us)
+{
+    g->stats.wakeups++;
+    expire_until(g, now_us);
+}
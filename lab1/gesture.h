@@ -0,0 +1,93 @@
+#ifndef GESTURE_H
+#define GESTURE_H
+
+/*
+ * Incremental gesture recognizer on timestamped button edges.
+ *
+ * Raw press/release edges go in through gesture_edge(); debounced
+ * gestures come out through the emit callback:
+ *
+ *  - GESTURE_PRESS   buttons without flags: at once on press
+ *  - GESTURE_CLICK   on release, or once the double-click window closes
+ *  - GESTURE_DOUBLE  second press within the double-click window
+ *  - GESTURE_LONG    held past the long-press time (no click follows)
+ *  - GESTURE_CHORD   GESTURE_CHORD buttons pressed within the chord window
+ *                    of each other; none of them clicks or long-presses
+ *
+ * Nothing polls: every timeout is a deadline, gesture_next_deadline()
+ * says when the next one is due and gesture_expire() handles it. Each
+ * edge or deadline is constant work (a scan of at most
+ * GESTURE_MAX_BUTTONS). Debouncing is a lockout after each accepted
+ * edge; an edge that bounced back during it is reconciled at its end.
+ *
+ * Plain C with no locking: feed edges and deadlines from contexts that
+ * cannot preempt each other.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define GESTURE_MAX_BUTTONS 8
+
+/* per-button flags */
+#define GESTURE_LONG    0x01
+#define GESTURE_DOUBLE  0x02
+#define GESTURE_CHORD   0x04    // member of the chord group
+
+typedef enum _gesture_kind_t {
+    GESTURE_PRESS = 0,
+    GESTURE_CLICK,
+    GESTURE_DOUBLE_CLICK,
+    GESTURE_LONG_PRESS,
+    GESTURE_CHORD_PRESS,
+} gesture_kind_t;
+
+/* buttons: bit mask of the buttons involved (one bit except for chords) */
+typedef void (*gesture_emit_t)(void *ctx, gesture_kind_t kind, uint8_t buttons, uint32_t t_us);
+
+typedef struct _gesture_timing_t {
+    uint32_t debounce_us;
+    uint32_t long_us;
+    uint32_t double_us;     // release to second press
+    uint32_t chord_us;      // press to press
+} gesture_timing_t;
+
+typedef struct _gesture_button_t {
+    uint8_t flags;
+    uint8_t state;          // GST_* in gesture.c
+    bool raw;               // last edge seen, pressed = true
+    bool down;              // debounced level
+    bool settling;          // in the lockout after an accepted edge
+    uint32_t settle_us;     // lockout end
+    uint32_t t_us;          // last accepted press or release
+} gesture_button_t;
+
+typedef struct _gesture_stats_t {
+    uint32_t edges;
+    uint32_t bounces;       // edges absorbed by the lockout
+    uint32_t wakeups;       // gesture_expire() calls
+    uint32_t emitted;
+} gesture_stats_t;
+
+typedef struct _gesture_t {
+    gesture_timing_t timing;
+    gesture_emit_t emit;
+    void *ctx;
+    uint8_t n_buttons;
+    gesture_button_t buttons[GESTURE_MAX_BUTTONS];
+    gesture_stats_t stats;
+} gesture_t;
+
+void gesture_init(gesture_t *g, const uint8_t *flags, uint8_t n_buttons,
+                  const gesture_timing_t *timing, gesture_emit_t emit, void *ctx);
+
+/* one raw edge of button `button` at t_us */
+void gesture_edge(gesture_t *g, uint8_t button, bool pressed, uint32_t t_us);
+
+/* earliest pending deadline; false when idle */
+bool gesture_next_deadline(const gesture_t *g, uint32_t *t_us);
+
+/* handle every deadline due at now_us */
+void gesture_expire(gesture_t *g, uint32_t now_us);
+
+#endif /* GESTURE_H */
@@ -0,0 +1,24 @@
+#ifndef HOT_PATH_H
+#define HOT_PATH_H
+
+/*
+ * Placement markers for the lab1 hot path: button ISR, event queue,
+ * FSM dispatch and LED output. With LAB1_RAM_HOT_PATH (CMake
+ * LAB1_CODE_PLACEMENT=hot_path) they are linked into SRAM, so an XIP
+ * cache miss cannot stretch interrupt latency or step timing; otherwise
+ * they expand to nothing and the code stays plain C.
+ *
+ * Anything called from a HOT_FUNC must be inline or HOT_FUNC itself,
+ * or the call lands back in flash.
+ */
+
+#ifdef LAB1_RAM_HOT_PATH
+#include "pico/platform.h"
+#define HOT_FUNC(name) __not_in_flash_func(name)
+#define HOT_DATA       __not_in_flash("lab1_hot")   // const tables the hot path reads
+#else
+#define HOT_FUNC(name) name
+#define HOT_DATA
+#endif
+
+#endif /* HOT_PATH_H */
@@ -0,0 +1,141 @@
+/*
+ * Worst-case button ISR entry latency, per code placement.
+ *
+ * Configure with -DLAB1_ISR_BENCH=ON and one LAB1_CODE_PLACEMENT (flash,
+ * hot_path or copy_to_ram), flash lab1_isr_bench.uf2 and read the table
+ * over USB stdio; repeat per placement. lab1.c is compiled in unmodified
+ * (its main() renamed), so the ISR under test is the real one.
+ *
+ * Each trial forces a falling-edge interrupt on BTN1_PIN from software and
+ * times with the M33 cycle counter:
+ *   entry - force to the first statement of button_isr()
+ *   done  - force to the ISR having returned
+ * "cold" trials invalidate the XIP cache first, as when the FSM or USB
+ * stack has streamed other code through it; "warm" trials do not. The
+ * gesture recognizer is reset before each trial so every ISR sees a
+ * fresh, debounced press and re-arms the deadline alarm.
+ */
+
+#include "pico/stdlib.h"
+#include "pico/stdio_usb.h"
+#include "hardware/clocks.h"
+#include "hardware/irq.h"
+#include "hardware/structs/io_bank0.h"
+#include "hardware/structs/m33.h"
+#include "hardware/xip_cache.h"
+#include <stdio.h>
+
+static volatile uint32_t bench_entry_cyc;
+static volatile bool bench_entered;
+
+/* runs inside button_isr, so it shares its placement */
+static __force_inline void bench_entry(uint gpio)
+{
+    bench_entry_cyc = m33_hw->dwt_cyccnt;
+    io_bank0_hw->proc0_irq_ctrl.intf[gpio / 8] = 0;    // a forced IRQ stays set until cleared
+    bench_entered = true;
+}
+
+#define LAB1_ISR_ENTRY_HOOK(gpio) bench_entry(gpio)
+
+#define main lab1_main
+#include "lab1.c"
+#undef main
+
+#define TRIALS       1000
+#define REPORT_EVERY 5000   // ms between runs
+
+typedef struct _lat_t {
+    uint32_t min, max;
+    uint64_t sum;
+} lat_t;
+
+static void lat_add(lat_t *l, uint32_t cyc)
+{
+    if (cyc < l->min) l->min = cyc;
+    if (cyc > l->max) l->max = cyc;
+    l->sum += cyc;
+}
+
+/* harness, always in SRAM: its own fetches must not land in the window */
+static void __not_in_flash_func(trigger)(uint32_t *entry, uint32_t *done)
+{
+    bench_entered = false;
+
+    uint32_t t0 = m33_hw->dwt_cyccnt;
+    io_bank0_hw->proc0_irq_ctrl.intf[BTN1_PIN / 8] = GPIO_IRQ_EDGE_FALL << (4 * (BTN1_PIN % 8));
+    while (!bench_entered) {
+        tight_loop_contents();
+    }
+    uint32_t t1 = m33_hw->dwt_cyccnt;
+
+    *entry = bench_entry_cyc - t0;
+    *done = t1 - t0;
+}
+
+static void run(bool cold, lat_t *entry, lat_t *done)
+{
+    evq_entry_t evts[EVQ_CAPACITY];
+
+    *entry = (lat_t){ UINT32_MAX, 0, 0 };
+    *done = *entry;
+
+    for (int i = 0; i < TRIALS; i++) {
+        uint32_t e, d;
+
+        gestures_reset();
+        if (cold) xip_cache_invalidate_all();
+
+        trigger(&e, &d);
+        lat_add(entry, e);
+        lat_add(done, d);
+
+        get_events(evts, EVQ_CAPACITY);
+        sleep_us(100);
+    }
+}
+
+static void print_row(const char *name, const lat_t *entry, const lat_t *done, uint32_t mhz)
+{
+    printf("%-5s %6lu %6lu %6lu  %6lu ns   %6lu %6lu %6lu  %6lu ns\n", name,
+           (unsigned long)entry->min, (unsigned long)(entry->sum / TRIALS), (unsigned long)entry->max,
+           (unsigned long)(entry->max * 1000u / mhz),
+           (unsigned long)done->min, (unsigned long)(done->sum / TRIALS), (unsigned long)done->max,
+           (unsigned long)(done->max * 1000u / mhz));
+}
+
+int main(void)
+{
+    stdio_init_all();
+    private_init();     // lab1's buttons, LEDs, queue and ISR
+
+    /* above USB servicing, so its handler can't show up in the max; the
+       gesture alarm moves with it, the two must not preempt each other */
+    irq_set_priority(IO_IRQ_BANK0, PICO_HIGHEST_IRQ_PRIORITY);
+    irq_set_priority(deadline_irq_num(), PICO_HIGHEST_IRQ_PRIORITY);
+
+    /* cycle counter */
+    m33_hw->demcr |= M33_DEMCR_TRCENA_BITS;
+    m33_hw->dwt_ctrl |= M33_DWT_CTRL_CYCCNTENA_BITS;
+
+    while (!stdio_usb_connected()) {
+        sleep_ms(10);
+    }
+
+    uint32_t mhz = clock_get_hz(clk_sys) / 1000000;
+
+    while (1) {
+        lat_t entry_cold, done_cold, entry_warm, done_warm;
+
+        run(true, &entry_cold, &done_cold);
+        run(false, &entry_warm, &done_warm);
+
+        printf("\nlab1 ISR latency, placement %s, %d trials, clk_sys %lu MHz\n",
+               LAB1_CODE_PLACEMENT, TRIALS, (unsigned long)mhz);
+        printf("      entry cycles min/avg/max  max       done cycles min/avg/max   max\n");
+        print_row("cold", &entry_cold, &done_cold, mhz);
+        print_row("warm", &entry_warm, &done_warm, mhz);
+
+        sleep_ms(REPORT_EVERY);
+    }
+}
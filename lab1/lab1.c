@@ -1,9 +1,25 @@
 #include "pico/stdlib.h"
 #include "pico/util/queue.h"
 #include "hardware/pwm.h"
+#include "hardware/sync.h"
+#include "hardware/structs/io_bank0.h"
+#include "hardware/structs/pads_bank0.h"
 #include <stdbool.h>
 
+#include "deadline.h"
+#include "event_queue.h"
+#include "gesture.h"
+#include "hot_path.h"
+
+#ifdef LAB1_TRACE_CAPTURE
+#include "pico/stdio_usb.h"
+#include "input_trace.h"
+#endif
+
 #define BUTTON_DEBOUNCE_DELAY 50
+#define LONG_PRESS_MS         600
+#define DOUBLE_CLICK_MS       250
+#define CHORD_MS              80
 
 #define LED1_GPIO 0
 #define LED2_GPIO 1
@@ -14,6 +30,11 @@
 #define BTN2_PIN 21
 #define BTN3_PIN 22
 
+/* Instrumentation point at the top of button_isr (see isr_bench.c) */
+#ifndef LAB1_ISR_ENTRY_HOOK
+#define LAB1_ISR_ENTRY_HOOK(gpio) ((void)(gpio))
+#endif
+
 /* Function pointer primitive */
 typedef void (*state_func_t)(void);
 
@@ -30,70 +51,272 @@ typedef enum _event_t {
     b1_evt = 0,
     b2_evt = 1,
     b3_evt = 2,
-    no_evt = 3
+    b1_long_evt = 3,
+    b2_long_evt = 4,
+    b1_dbl_evt = 5,
+    chord_evt = 6,      // b1 + b2 together
+    no_evt = 7
 } event_t;
 
-static queue_t event_queue;
+static evq_t event_queue;
+
+/* Per-button queue policy: repeated presses collapse to the latest one;
+   b3 (PWM mode in/out) outranks and flushes pending b1/b2 presses */
+static const evq_policy_t event_policy[no_evt] HOT_DATA = {
+    [b1_evt]      = { 0, EVQ_COALESCE },
+    [b2_evt]      = { 0, EVQ_COALESCE },
+    [b3_evt]      = { 1, EVQ_COALESCE | EVQ_PREEMPT },
+    [b1_long_evt] = { 0, EVQ_COALESCE },
+    [b2_long_evt] = { 0, EVQ_COALESCE },
+    [b1_dbl_evt]  = { 0, EVQ_COALESCE },
+    [chord_evt]   = { 1, EVQ_COALESCE | EVQ_PREEMPT },
+};
+
+/* Gestures per button, in gesture index order: b1 clicks, double-clicks
+   and long-presses, b2 clicks and long-presses, b1+b2 chord; b3 keeps
+   acting at once on press */
+static gesture_t gestures;
+
+static const uint8_t gesture_flags[] = {
+    GESTURE_LONG | GESTURE_DOUBLE | GESTURE_CHORD,  // b1
+    GESTURE_LONG | GESTURE_CHORD,                   // b2
+    0,                                              // b3
+};
+
+static const gesture_timing_t gesture_timing = {
+    BUTTON_DEBOUNCE_DELAY * 1000u, LONG_PRESS_MS * 1000u, DOUBLE_CLICK_MS * 1000u, CHORD_MS * 1000u
+};
 
 /* ===================== LED helpers ===================== */
-void leds_off(void) {
+void HOT_FUNC(leds_off)(void) {
     gpio_put(LED1_GPIO, 0);
     gpio_put(LED2_GPIO, 0);
     gpio_put(LED3_GPIO, 0);
     gpio_put(LED4_GPIO, 0);
 }
 
-void leds_on(void) {
+void HOT_FUNC(leds_on)(void) {
     gpio_put(LED1_GPIO, 1);
     gpio_put(LED2_GPIO, 1);
     gpio_put(LED3_GPIO, 1);
     gpio_put(LED4_GPIO, 1);
 }
 
-/* ===================== Button ISR with debounce ===================== */
-unsigned long button_time = 0;
+/* ===================== Input trace capture ===================== */
+#ifdef LAB1_TRACE_CAPTURE
+/* Raw edges queued by the ISR, encoded and streamed out by the main loop */
+typedef struct _trace_edge_t {
+    uint32_t t_us;
+    uint8_t pin;
+    uint8_t rising;
+    uint16_t lost;      // edges dropped on a full queue just before this one
+} trace_edge_t;
+
+static queue_t trace_queue;
+static uint32_t trace_last_us = 0;
+static uint32_t trace_frame_us = 0; // when this loop pass fetched its events
+static uint16_t trace_lost = 0;     // ISR only
+
+/* a full queue drops the edge; the next one that fits carries the count */
+static void trace_add(trace_edge_t *e)
+{
+    e->lost = trace_lost;
+    if (queue_try_add(&trace_queue, e)) trace_lost = 0;
+    else if (trace_lost < UINT16_MAX) trace_lost++;
+}
+
+static void trace_record(uint gpio, uint32_t events)
+{
+    trace_edge_t e;
+    e.t_us = time_us_32();
+    e.pin = (uint8_t)gpio;
+
+    /* both edges can be latched in one callback; log fall first */
+    if (events & GPIO_IRQ_EDGE_FALL) {
+        e.rising = 0;
+        trace_add(&e);
+    }
+    if (events & GPIO_IRQ_EDGE_RISE) {
+        e.rising = 1;
+        trace_add(&e);
+    }
+}
 
-void button_isr(uint gpio, uint32_t events) 
+static void trace_init(void)
 {
-    if ((to_ms_since_boot(get_absolute_time())-button_time) > BUTTON_DEBOUNCE_DELAY) 
-    {
-        button_time = to_ms_since_boot(get_absolute_time());
-        
-        event_t evt;
-        switch(gpio)
-        {
-            case BTN1_PIN: 
-                evt = b1_evt; 
-                queue_try_add(&event_queue, &evt); 
-            break; 
-
-            case BTN2_PIN: 
-                evt = b2_evt; 
-                queue_try_add(&event_queue, &evt); 
-            break;
-
-            case BTN3_PIN: 
-                evt = b3_evt; 
-                queue_try_add(&event_queue, &evt);
-            break;
+    queue_init(&trace_queue, sizeof(trace_edge_t), 64);
+    stdio_init_all();
+
+    /* wait for the host so it never misses the header */
+    while (!stdio_usb_connected()) {
+        sleep_ms(10);
+    }
+
+    uint8_t hdr[INPUT_TRACE_HEADER_LEN];
+    size_t n = input_trace_header(hdr);
+    for (size_t i = 0; i < n; i++) putchar_raw(hdr[i]);
+    trace_last_us = time_us_32();
+    trace_frame_us = trace_last_us;
+}
+
+/* LED state as the replay target reports it (tools/replay/target_lab1.c) */
+static uint8_t trace_outputs(void)
+{
+    static const uint pins[] = { LED1_GPIO, LED2_GPIO, LED3_GPIO, LED4_GPIO };
+    uint8_t out = 0;
+
+    for (int i = 0; i < 4; i++) {
+        if (gpio_get_function(pins[i]) == GPIO_FUNC_SIO && gpio_is_dir_out(pins[i]) &&
+            gpio_get_out_level(pins[i])) {
+            out |= 1u << i;
+        }
+    }
+    if (gpio_get_function(LED1_GPIO) == GPIO_FUNC_PWM &&
+        (pwm_hw->en & (1u << pwm_gpio_to_slice_num(LED1_GPIO)))) {
+        out |= INPUT_TRACE_OUT_PWM;
+    }
+    return out;
+}
+
+static void trace_put(const uint8_t *rec, size_t n)
+{
+    for (size_t i = 0; i < n; i++) putchar_raw(rec[i]);
+}
+
+/* Called from the main loop where it paces itself: the edges that came
+   before this pass fetched its events, then the outputs the pass left */
+static void trace_frame(void)
+{
+    trace_edge_t e;
+    uint8_t rec[INPUT_TRACE_RECORD_MAX];
+
+    /* later edges stay queued, the stream is in time order */
+    while (queue_try_peek(&trace_queue, &e) && (int32_t)(e.t_us - trace_frame_us) <= 0) {
+        uint32_t delta_us = e.t_us - trace_last_us;
+
+        queue_try_remove(&trace_queue, &e);
+        trace_last_us = e.t_us;
+        if (e.lost) {
+            trace_put(rec, input_trace_encode_drop(rec, delta_us, e.lost));
+            delta_us = 0;
         }
+        trace_put(rec, input_trace_encode(rec, delta_us, e.pin, e.rising));
+    }
+
+    trace_put(rec, input_trace_encode_output(rec, trace_frame_us - trace_last_us,
+                                             trace_outputs()));
+    trace_last_us = trace_frame_us;
+    stdio_flush();
+}
+#endif
+
+/* ===================== Gestures to events ===================== */
+static void HOT_FUNC(gesture_event)(void *ctx, gesture_kind_t kind, uint8_t buttons, uint32_t t_us)
+{
+    event_t evt = no_evt;
+    (void)ctx;
+
+    /* drops and coalescing are counted in event_queue.stats */
+    switch (kind) {
+        case GESTURE_PRESS:
+        case GESTURE_CLICK:
+            evt = buttons == 0x1 ? b1_evt : buttons == 0x2 ? b2_evt : b3_evt;
+        break;
+
+        case GESTURE_LONG_PRESS:
+            evt = buttons == 0x1 ? b1_long_evt : b2_long_evt;
+        break;
+
+        case GESTURE_DOUBLE_CLICK:
+            evt = b1_dbl_evt;
+        break;
+
+        case GESTURE_CHORD_PRESS:
+            evt = chord_evt;
+        break;
     }
+    evq_post(&event_queue, evt, t_us / 1000);
+}
+
+/* Keep the alarm on the recognizer's next deadline; idle means no alarm */
+static void HOT_FUNC(gesture_rearm)(void)
+{
+    uint32_t t_us;
+
+    if (gesture_next_deadline(&gestures, &t_us)) deadline_set(t_us);
+    else                                         deadline_cancel();
+}
+
+static void HOT_FUNC(gesture_timeout)(uint32_t now_us)
+{
+    gesture_expire(&gestures, now_us);
+    gesture_rearm();
+}
+
+void gestures_reset(void)
+{
+    gesture_init(&gestures, gesture_flags, sizeof(gesture_flags), &gesture_timing,
+                 gesture_event, NULL);
+}
+
+/* ===================== Button ISR ===================== */
+/* Raw edges into the recognizer, which debounces them */
+void HOT_FUNC(button_isr)(uint gpio, uint32_t events) 
+{
+    LAB1_ISR_ENTRY_HOOK(gpio);
+
+#ifdef LAB1_TRACE_CAPTURE
+    trace_record(gpio, events);
+#endif
+
+    /* the 32-bit timer read is inline; the 64-bit one is a call into flash */
+    uint32_t now_us = time_us_32();
+    uint8_t button;
+
+    switch(gpio)
+    {
+        case BTN1_PIN: button = 0; break;
+        case BTN2_PIN: button = 1; break;
+        case BTN3_PIN: button = 2; break;
+        default: return;
+    }
+
+    /* active low: fall = press. Both latched means a bounce; the pin
+       level tells which came last */
+    if ((events & GPIO_IRQ_EDGE_FALL) && (events & GPIO_IRQ_EDGE_RISE)) {
+        bool pressed = !gpio_get(gpio);
+        gesture_edge(&gestures, button, !pressed, now_us);
+        gesture_edge(&gestures, button, pressed, now_us);
+    } else if (events & GPIO_IRQ_EDGE_FALL) {
+        gesture_edge(&gestures, button, true, now_us);
+    } else if (events & GPIO_IRQ_EDGE_RISE) {
+        gesture_edge(&gestures, button, false, now_us);
+    }
+
+    gesture_rearm();
 }
 
 /* ===================== Init ===================== */
 void private_init(void) {
-    /* Event queue setup */
-    queue_init(&event_queue, sizeof(event_t), 32);
+    /* Event queue and gesture recognizer setup */
+    evq_init(&event_queue, event_policy, no_evt);
+    gestures_reset();
+    deadline_init(gesture_timeout);
 
     /* Button setup: active-low with pull-up */
     gpio_init(BTN1_PIN); gpio_set_dir(BTN1_PIN, GPIO_IN); gpio_pull_up(BTN1_PIN);
     gpio_init(BTN2_PIN); gpio_set_dir(BTN2_PIN, GPIO_IN); gpio_pull_up(BTN2_PIN);
     gpio_init(BTN3_PIN); gpio_set_dir(BTN3_PIN, GPIO_IN); gpio_pull_up(BTN3_PIN);
 
-    /* Enable interrupts: falling edge = press */
-    gpio_set_irq_enabled_with_callback(BTN1_PIN, GPIO_IRQ_EDGE_FALL, true, &button_isr);
-    gpio_set_irq_enabled(BTN2_PIN, GPIO_IRQ_EDGE_FALL, true);
-    gpio_set_irq_enabled(BTN3_PIN, GPIO_IRQ_EDGE_FALL, true);
+#ifdef LAB1_TRACE_CAPTURE
+    trace_init();
+#endif
+
+    /* Enable interrupts on both edges: the gestures need releases too */
+    const uint32_t btn_edges = GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE;
+    gpio_set_irq_enabled_with_callback(BTN1_PIN, btn_edges, true, &button_isr);
+    gpio_set_irq_enabled(BTN2_PIN, btn_edges, true);
+    gpio_set_irq_enabled(BTN3_PIN, btn_edges, true);
 
     /* LED setup */
     gpio_init(LED1_GPIO); gpio_set_dir(LED1_GPIO, GPIO_OUT); gpio_put(LED1_GPIO, 0); 
@@ -103,22 +326,24 @@ void private_init(void) {
 }
 
 /* ===================== Event get ===================== */
-event_t get_event(void)
+/* Everything pending, oldest first; the ISR is held off while copying */
+size_t HOT_FUNC(get_events)(evq_entry_t *evts, size_t max)
 {
-    event_t evt = no_evt; 
-    if (queue_try_remove(&event_queue, &evt))
-    { 
-        return evt; 
-    }
-    return no_evt; 
+    uint32_t irq = save_and_disable_interrupts();
+    size_t n = evq_take_all(&event_queue, evts, max);
+#ifdef LAB1_TRACE_CAPTURE
+    trace_frame_us = time_us_32();  // no edge ISR can split the batch from its stamp
+#endif
+    restore_interrupts(irq);
+    return n;
 }
 
 /* ===================== State implementations ===================== */
 /* ---- S0: running light forward ---- */
-void enter_state_0(void) { leds_off(); }
-void exit_state_0(void)  { leds_off(); }
+void HOT_FUNC(enter_state_0)(void) { leds_off(); }
+void HOT_FUNC(exit_state_0)(void)  { leds_off(); }
 
-void do_state_0(void) {
+void HOT_FUNC(do_state_0)(void) {
     static int i = 0;
     leds_off();
     switch(i) {
@@ -131,10 +356,10 @@ void do_state_0(void) {
 }
 
 /* ---- S1: all LEDs blink ---- */
-void enter_state_1(void) { leds_off(); }
-void exit_state_1(void)  { leds_off(); }
+void HOT_FUNC(enter_state_1)(void) { leds_off(); }
+void HOT_FUNC(exit_state_1)(void)  { leds_off(); }
 
-void do_state_1(void) {
+void HOT_FUNC(do_state_1)(void) {
     static bool on = false;
     if (on) leds_off();
     else    leds_on();
@@ -142,10 +367,10 @@ void do_state_1(void) {
 }
 
 /* ---- S2: running light backward ---- */
-void enter_state_2(void) { leds_off(); }
-void exit_state_2(void)  { leds_off(); }
+void HOT_FUNC(enter_state_2)(void) { leds_off(); }
+void HOT_FUNC(exit_state_2)(void)  { leds_off(); }
 
-void do_state_2(void) {
+void HOT_FUNC(do_state_2)(void) {
     static int i = 3;   // start from last LED
     leds_off();
 
@@ -163,11 +388,21 @@ void do_state_2(void) {
 static uint pwm_slice = 0;
 static uint pwm_chan  = 0;
 
-void enter_state_3(void) {
+/* gpio_set_function() stays in flash; these are its register writes */
+static void HOT_FUNC(led1_set_function)(uint fn) {
+    hw_write_masked(&pads_bank0_hw->io[LED1_GPIO], PADS_BANK0_GPIO0_IE_BITS,
+                    PADS_BANK0_GPIO0_IE_BITS | PADS_BANK0_GPIO0_OD_BITS);
+    io_bank0_hw->io[LED1_GPIO].ctrl = fn << IO_BANK0_GPIO0_CTRL_FUNCSEL_LSB;
+#if HAS_PADS_BANK0_ISOLATION
+    hw_clear_bits(&pads_bank0_hw->io[LED1_GPIO], PADS_BANK0_GPIO0_ISO_BITS);
+#endif
+}
+
+void HOT_FUNC(enter_state_3)(void) {
     leds_off();
 
     /* switch LED1_GPIO to PWM function */
-    gpio_set_function(LED1_GPIO, GPIO_FUNC_PWM);
+    led1_set_function(GPIO_FUNC_PWM);
 
     pwm_slice = pwm_gpio_to_slice_num(LED1_GPIO);
     pwm_chan  = pwm_gpio_to_channel(LED1_GPIO);
@@ -184,18 +419,18 @@ void enter_state_3(void) {
     pwm_set_chan_level(pwm_slice, pwm_chan, 0);
 }
 
-void exit_state_3(void) {
+void HOT_FUNC(exit_state_3)(void) {
     /* disable PWM and restore GPIO */
     pwm_set_enabled(pwm_slice, false);
 
-    gpio_set_function(LED1_GPIO, GPIO_FUNC_SIO);
+    led1_set_function(GPIO_FUNC_SIO);
     gpio_set_dir(LED1_GPIO, GPIO_OUT);
     gpio_put(LED1_GPIO, 0);
 
     leds_off();
 }
 
-void do_state_3(void) {
+void HOT_FUNC(do_state_3)(void) {
     static int level = 0;
     static int step  = 500;  // tune speed = higher -> faster
     static int dir   = 1;
@@ -209,26 +444,52 @@ void do_state_3(void) {
 }
 
 /* ===================== State objects ===================== */
-const state_t state0 = { 0, enter_state_0, do_state_0, exit_state_0, 500 };
-const state_t state1 = { 1, enter_state_1, do_state_1, exit_state_1, 300 };
-const state_t state2 = { 2, enter_state_2, do_state_2, exit_state_2, 100 };
-const state_t state3 = { 3, enter_state_3, do_state_3, exit_state_3, 10 };
+const state_t state0 HOT_DATA = { 0, enter_state_0, do_state_0, exit_state_0, 500 };
+const state_t state1 HOT_DATA = { 1, enter_state_1, do_state_1, exit_state_1, 300 };
+const state_t state2 HOT_DATA = { 2, enter_state_2, do_state_2, exit_state_2, 100 };
+const state_t state3 HOT_DATA = { 3, enter_state_3, do_state_3, exit_state_3, 10 };
 
 /* ===================== State table ===================== */
-static const state_t* state_table[4][4] = {
-    /*       {  b1_evt,  b2_evt,  b3_evt,  no_evt } */
-    /* S0 */ { &state2, &state1, &state3, &state0 },
-    /* S1 */ { &state0, &state2, &state3, &state1 },
-    /* S2 */ { &state1, &state0, &state3, &state2 },
-    /* S3 */ { &state0, &state0, &state0, &state3 }  // any button -> S0, none -> stay S3
+/* b1 long = home (S0), b2 long = blink (S1), b1 double = reverse the
+   running light, b1+b2 chord = PWM like b3 */
+static const state_t* const state_table[4][8] HOT_DATA = {
+    /*       {  b1_evt,  b2_evt,  b3_evt, b1_long, b2_long,  b1_dbl,   chord,  no_evt } */
+    /* S0 */ { &state2, &state1, &state3, &state0, &state1, &state2, &state3, &state0 },
+    /* S1 */ { &state0, &state2, &state3, &state0, &state1, &state1, &state3, &state1 },
+    /* S2 */ { &state1, &state0, &state3, &state0, &state1, &state0, &state3, &state2 },
+    /* S3 */ { &state0, &state0, &state0, &state0, &state0, &state0, &state0, &state3 }  // any button -> S0, none -> stay S3
 };
 
+/* ===================== FSM dispatch ===================== */
+/* Walk the table through the whole batch; Exit/Enter only on a real change */
+const state_t* HOT_FUNC(fsm_dispatch)(const state_t* current_state, const evq_entry_t *evts, size_t n)
+{
+    const state_t* next_state = current_state;
+
+    for (size_t i = 0; i < n; i++) {
+        next_state = state_table[next_state->id][evts[i].type];
+    }
+
+    /* Transition only if state actually changes */
+    if (next_state != current_state) {
+        if (current_state->Exit) {
+            current_state->Exit();
+        }
+
+        current_state = next_state;
+
+        if (current_state->Enter) {
+            current_state->Enter();
+        }
+    }
+    return current_state;
+}
+
 /* ===================== Main ===================== */
 int main(void) {
     private_init();
 
     const state_t* current_state = &state0;
-    const state_t* next_state    = current_state;
 
     /* Enter only once at startup */
     if (current_state->Enter) {
@@ -241,28 +502,18 @@ int main(void) {
             current_state->Do();
         }
 
+#ifdef LAB1_TRACE_CAPTURE
+        trace_frame();
+#endif
+
         /* Pace the loop (allowed here, not inside Do) */
         sleep_ms(current_state->delay_ms);
 
-        /* Fetch event */
-        event_t evt = get_event();
+        /* Fetch all pending events */
+        evq_entry_t evts[EVQ_CAPACITY];
+        size_t n = get_events(evts, EVQ_CAPACITY);
 
-        /* Decide next state */
-        if (evt != no_evt) {
-            next_state = state_table[current_state->id][evt];
-
-            /* Transition only if state actually changes */
-            if (next_state != current_state) {
-                if (current_state->Exit) {
-                    current_state->Exit();
-                }
-
-                current_state = next_state;
-
-                if (current_state->Enter) {
-                    current_state->Enter();
-                }
-            }
-        }
+        /* Decide and apply the next state */
+        current_state = fsm_dispatch(current_state, evts, n);
     }
 }
@@ -0,0 +1,76 @@
+# Post-build report: where each lab1 hot-path symbol ended up and how big
+# it is. Run by lab1_code_placement() in CMakeLists.txt:
+#   cmake -DNM=<nm> -DELF=<elf> -DOUT=<txt> -DPLACEMENT=<mode> -DSYMBOLS=a,b,c -P placement_report.cmake
+
+execute_process(COMMAND ${NM} --defined-only --print-size ${ELF}
+        OUTPUT_VARIABLE nm_out
+        RESULT_VARIABLE nm_rc)
+if (NOT nm_rc EQUAL 0)
+    message(FATAL_ERROR "${NM} failed on ${ELF}")
+endif()
+string(REPLACE "\n" ";" nm_lines "${nm_out}")
+string(REPLACE "," ";" symbols "${SYMBOLS}")
+
+# RP2350 map: XIP flash 0x10000000.., SRAM 0x20000000..
+function(region_of addr out)
+    string(SUBSTRING "${addr}" 0 1 top)
+    if (top STREQUAL "1")
+        set(${out} "flash" PARENT_SCOPE)
+    elseif (top STREQUAL "2")
+        set(${out} "SRAM" PARENT_SCOPE)
+    else()
+        set(${out} "?" PARENT_SCOPE)
+    endif()
+endfunction()
+
+set(report "lab1 hot path placement (LAB1_CODE_PLACEMENT=${PLACEMENT})\n")
+string(APPEND report "symbol            address      size  region\n")
+set(flash_bytes 0)
+set(sram_bytes 0)
+set(inlined "")
+set(blanks "                  ")
+
+foreach (sym IN LISTS symbols)
+    set(found FALSE)
+    foreach (line IN LISTS nm_lines)
+        # "<addr> <size> <type> <name>"; only sized code and data symbols
+        if (line MATCHES "^([0-9a-fA-F]+) ([0-9a-fA-F]+) [tTdDrRbB] ${sym}$")
+            set(addr ${CMAKE_MATCH_1})
+            math(EXPR size "0x${CMAKE_MATCH_2}")
+            region_of(${addr} region)
+            if (region STREQUAL "SRAM")
+                math(EXPR sram_bytes "${sram_bytes} + ${size}")
+            elseif (region STREQUAL "flash")
+                math(EXPR flash_bytes "${flash_bytes} + ${size}")
+            endif()
+
+            string(LENGTH "${sym}" len)
+            math(EXPR pad "18 - ${len}")
+            if (pad LESS 1)
+                set(pad 1)
+            endif()
+            string(SUBSTRING "${blanks}" 0 ${pad} spaces)
+            string(LENGTH "${size}" len)
+            math(EXPR pad2 "6 - ${len}")
+            if (pad2 LESS 1)
+                set(pad2 1)
+            endif()
+            string(SUBSTRING "${blanks}" 0 ${pad2} spaces2)
+            string(APPEND report "${sym}${spaces}0x${addr}${spaces2}${size}  ${region}\n")
+            set(found TRUE)
+            break()
+        endif()
+    endforeach()
+    if (NOT found)
+        list(APPEND inlined ${sym})
+    endif()
+endforeach()
+
+if (inlined)
+    string(REPLACE ";" " " inlined "${inlined}")
+    string(APPEND report "inlined / not linked: ${inlined}\n")
+endif()
+string(APPEND report "total: ${sram_bytes} bytes in SRAM, ${flash_bytes} bytes in flash\n")
+
+file(WRITE ${OUT} "${report}")
+message(STATUS "lab1 hot path: ${sram_bytes} bytes in SRAM, ${flash_bytes} bytes in flash (${OUT})")
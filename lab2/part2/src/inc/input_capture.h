@@ -0,0 +1,21 @@
+#ifndef INPUT_CAPTURE_H
+#define INPUT_CAPTURE_H
+
+#include <zephyr/drivers/gpio.h>
+
+#ifdef CONFIG_APP_INPUT_TRACE
+/* start the trace streaming thread and emit the trace header */
+void input_capture_init(void);
+
+/* ISR-safe: log one edge of @pin */
+void input_capture_edge(gpio_pin_t pin, bool rising);
+#else
+static inline void input_capture_init(void) {}
+static inline void input_capture_edge(gpio_pin_t pin, bool rising)
+{
+	ARG_UNUSED(pin);
+	ARG_UNUSED(rising);
+}
+#endif
+
+#endif /* INPUT_CAPTURE_H */
@@ -0,0 +1,98 @@
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/uart.h>
+
+#include "input_capture.h"
+#include "input_trace.h"
+
+#ifdef CONFIG_APP_INPUT_TRACE
+
+// console or shell text on the same UART would corrupt the binary stream
+BUILD_ASSERT(!IS_ENABLED(CONFIG_UART_CONSOLE) && !IS_ENABLED(CONFIG_SHELL_BACKEND_SERIAL),
+	     "the input trace needs the console UART to itself, build with trace.conf");
+
+struct trace_edge {
+	int64_t ticks;
+	uint32_t lost; // edges dropped on a full queue just before this one
+	uint8_t pin;
+	uint8_t rising;
+};
+
+K_MSGQ_DEFINE(trace_msgq, sizeof(struct trace_edge), 64, 4);
+static K_SEM_DEFINE(trace_start, 0, 1);
+
+static int64_t trace_base_ticks;
+static uint32_t trace_lost; // only the ISR touches it
+
+static const struct device *const uart = DEVICE_DT_GET(DT_CHOSEN(zephyr_console));
+
+static void put_bytes(const uint8_t *buf, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		uart_poll_out(uart, buf[i]);
+	}
+}
+
+void input_capture_edge(gpio_pin_t pin, bool rising)
+{
+	struct trace_edge e = {
+		.ticks = k_uptime_ticks(),
+		.lost = trace_lost,
+		.pin = (uint8_t)pin,
+		.rising = rising,
+	};
+
+	// a full queue drops the edge, the ISR must never block; the next
+	// edge that fits carries the count out as a drop marker
+	if (k_msgq_put(&trace_msgq, &e, K_NO_WAIT) == 0) {
+		trace_lost = 0;
+	} else {
+		trace_lost++;
+	}
+}
+
+void input_capture_init(void)
+{
+	// time origin must predate the first edge the ISR can log
+	trace_base_ticks = k_uptime_ticks();
+	k_sem_give(&trace_start);
+}
+
+static void trace_task(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	k_sem_take(&trace_start, K_FOREVER);
+	if (!device_is_ready(uart)) {
+		return;
+	}
+
+	uint8_t rec[INPUT_TRACE_RECORD_MAX];
+	size_t n = input_trace_header(rec);
+	put_bytes(rec, n);
+
+	uint64_t last_us = k_ticks_to_us_floor64(trace_base_ticks);
+
+	while (1) {
+		struct trace_edge e;
+		k_msgq_get(&trace_msgq, &e, K_FOREVER);
+
+		uint64_t t_us = k_ticks_to_us_floor64(e.ticks);
+		uint32_t delta_us = (uint32_t)(t_us - last_us);
+
+		last_us = t_us;
+		if (e.lost) {
+			put_bytes(rec, input_trace_encode_drop(rec, delta_us, e.lost));
+			delta_us = 0;
+		}
+		n = input_trace_encode(rec, delta_us, e.pin, e.rising);
+		put_bytes(rec, n);
+	}
+}
+
+// lowest app priority: streaming must never delay the button/blink threads
+K_THREAD_DEFINE(trace_tid, 1024, trace_task, NULL, NULL, NULL, 7, 0, 0);
+
+#endif /* CONFIG_APP_INPUT_TRACE */
@@ -1,6 +1,9 @@
 #include <zephyr/kernel.h>
 #include <zephyr/drivers/gpio.h>
 
+#include "input_capture.h"
+#include "app_stats.h"
+
 #define DEBOUNCE_MS 50
 #define BLINK_DELAY_MS 200
 
@@ -21,6 +24,15 @@ static struct k_mutex led_mutex;
 
 static int current_led = 0; //shared variable current blinking LED
 static uint32_t last_accepted_press_ms = 0; // for debounce
+static uint32_t last_isr_cyc = 0; // ISR timestamp, for the wake-up latency
+
+// runtime statistics ("stats show" with CONFIG_APP_STATS)
+APP_STAT_COUNTER_DEFINE(st_blink_toggles, "blink.toggles");
+APP_STAT_HIST_DEFINE(st_blink_period, "blink.period", "us");
+APP_STAT_COUNTER_DEFINE(st_btn_irqs, "btn.irqs");
+APP_STAT_COUNTER_DEFINE(st_btn_presses, "btn.presses");
+APP_STAT_COUNTER_DEFINE(st_btn_bounces, "btn.bounces");
+APP_STAT_HIST_DEFINE(st_btn_latency, "btn.isr_to_task", "us");
 
 void blinky_task(void *p1, void *p2, void *p3)
 {
@@ -28,8 +40,15 @@ void blinky_task(void *p1, void *p2, void *p3)
 	ARG_UNUSED(p2);
 	ARG_UNUSED(p3);
 
+	uint32_t last_cyc = k_cycle_get_32();
+
 	while (1) {
 		int idx;
+		uint32_t now_cyc = k_cycle_get_32();
+
+		// loop period: BLINK_DELAY_MS plus wake-up jitter
+		app_stat_hist_record(&st_blink_period, k_cyc_to_us_floor32(now_cyc - last_cyc));
+		last_cyc = now_cyc;
 
 		// read current_led atomically
 		k_mutex_lock(&led_mutex, K_FOREVER);
@@ -38,6 +57,7 @@ void blinky_task(void *p1, void *p2, void *p3)
 
 		// blink selected LED only
 		gpio_pin_toggle_dt(&leds[idx]);
+		app_stat_inc(&st_blink_toggles);
 		k_msleep(BLINK_DELAY_MS);
 	}
 }
@@ -49,6 +69,17 @@ static void button_isr(const struct device *dev, struct gpio_callback *cb, uint3
 	ARG_UNUSED(cb);
 	ARG_UNUSED(pins);
 
+#ifdef CONFIG_APP_INPUT_TRACE
+	// capture mode interrupts on both edges; only presses reach the task
+	bool pressed = gpio_pin_get_dt(&button) > 0;
+	input_capture_edge(button.pin, !pressed);
+	if (!pressed) {
+		return;
+	}
+#endif
+
+	last_isr_cyc = k_cycle_get_32();
+	app_stat_inc(&st_btn_irqs);
 	k_sem_give(&btn_sem); // signal the button task
 }
 
@@ -60,13 +91,16 @@ void button_task(void *p1, void *p2, void *p3)
 
 	while (1) {
 		k_sem_take(&btn_sem, K_FOREVER); // wait for button press signal
+		app_stat_hist_record(&st_btn_latency, k_cyc_to_us_floor32(k_cycle_get_32() - last_isr_cyc));
 
 		// button debouncing 
         uint32_t now = k_uptime_get_32();
         if ((now - last_accepted_press_ms) < DEBOUNCE_MS) {
+            app_stat_inc(&st_btn_bounces);
             continue;
         }
         last_accepted_press_ms = now;
+        app_stat_inc(&st_btn_presses);
 
 		k_mutex_lock(&led_mutex, K_FOREVER);
 		current_led = (current_led + 1) % 4;
@@ -96,7 +130,12 @@ int main(void)
     // configure button with interrupt
 	if (!gpio_is_ready_dt(&button)) return 0;
 	gpio_pin_configure_dt(&button, GPIO_INPUT);
+#ifdef CONFIG_APP_INPUT_TRACE
+	input_capture_init();
+	gpio_pin_interrupt_configure_dt(&button, GPIO_INT_EDGE_BOTH); // log releases as well
+#else
 	gpio_pin_interrupt_configure_dt(&button, GPIO_INT_EDGE_TO_ACTIVE); //trigger on pin state change to logical level 1
+#endif
 	gpio_init_callback(&button_cb, button_isr, BIT(button.pin));
 	gpio_add_callback(button.port, &button_cb);
 
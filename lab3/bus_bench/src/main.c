@@ -0,0 +1,151 @@
+/*
+ * Several BME680s on one I2C bus under the lab3/common bus scheduler.
+ *
+ * The sensors and their rates come from the lab3,bus-schedule node of
+ * the board overlay: per sensor a period and a conversion budget. Each
+ * sensor gets the highest T/P/H oversampling whose conversion fits its
+ * budget (no gas, so the heater does not stretch it), and is read as
+ * soon as that conversion is done.
+ *
+ * The schedule runs for CONFIG_BENCH_SECONDS interleaved, then as the
+ * serial trigger/wait/read baseline, and prints for each the bus
+ * utilization and per sensor the achieved rate, overruns, trigger
+ * lateness and interval jitter.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/sys/printk.h>
+#include <stdlib.h>
+
+#include "bme680_raw.h"
+#include "bus_sched.h"
+
+#define SCHED_NODE DT_COMPAT_GET_ANY_STATUS_OKAY(lab3_bus_schedule)
+
+#if !DT_NODE_EXISTS(SCHED_NODE)
+#error "no lab3,bus-schedule node in the devicetree"
+#endif
+
+struct bme_slot {
+    const struct device *bus;
+    uint16_t addr;
+    struct bme680_raw raw;
+    struct bme680_data last;
+};
+
+#define SENSOR_NODE(node) DT_PHANDLE(node, sensor)
+
+#define SLOT(node)                                                  \
+    {                                                               \
+        .bus = DEVICE_DT_GET(DT_BUS(SENSOR_NODE(node))),            \
+        .addr = DT_REG_ADDR(SENSOR_NODE(node)),                     \
+    },
+
+#define SCHED_DEV(node)                                             \
+    {                                                               \
+        .name = DT_NODE_FULL_NAME(node),                            \
+        .period_us = DT_PROP(node, period_ms) * 1000,               \
+        .conversion_us = DT_PROP(node, conversion_us),              \
+        .ops = &bme_ops,                                            \
+    },
+
+static int bme_trigger(struct bus_sched_dev *dev)
+{
+    struct bme_slot *slot = dev->ctx;
+
+    return bme680_raw_trigger(&slot->raw, -1);
+}
+
+static int bme_read(struct bus_sched_dev *dev)
+{
+    struct bme_slot *slot = dev->ctx;
+
+    return bme680_raw_read(&slot->raw, &slot->last);
+}
+
+static const struct bus_sched_ops bme_ops = { bme_trigger, bme_read };
+
+static struct bme_slot slots[] = { DT_FOREACH_CHILD_STATUS_OKAY(SCHED_NODE, SLOT) };
+static struct bus_sched_dev devs[] = { DT_FOREACH_CHILD_STATUS_OKAY(SCHED_NODE, SCHED_DEV) };
+
+BUILD_ASSERT(ARRAY_SIZE(devs) > 0, "the bus schedule has no sensors");
+
+/* highest equal T/P/H oversampling that converts within budget_us */
+static uint8_t pick_os(uint32_t budget_us)
+{
+    for (uint8_t os = BME680_OS_16X; os > BME680_OS_1X; os--) {
+        if (bme680_tph_duration_us(os, os, os) <= budget_us) return os;
+    }
+    return BME680_OS_1X;
+}
+
+static int setup(struct bus_sched_dev *dev, struct bme_slot *slot)
+{
+    uint8_t os = pick_os(dev->conversion_us);
+    const struct bme680_raw_cfg cfg = { os, os, os, BME680_FILTER_OFF };
+
+    if (!device_is_ready(slot->bus)) {
+        printk("%s: %s not ready\n", dev->name, slot->bus->name);
+        return -ENODEV;
+    }
+    if (bme680_raw_init(&slot->raw, slot->bus, slot->addr) != 0 ||
+        bme680_raw_configure(&slot->raw, &cfg) != 0) {
+        printk("%s: no BME680 at 0x%02x\n", dev->name, slot->addr);
+        return -EIO;
+    }
+
+    /* read when the conversion is done, not at the end of the budget */
+    uint32_t conv_us = bme680_raw_duration_us(&slot->raw, 0);
+
+    if (conv_us > dev->conversion_us) {
+        printk("%s: budget %u us is below x1 conversion, using %u us\n", dev->name,
+               dev->conversion_us, conv_us);
+    }
+    printk("  %-8s 0x%02x %5u ms  budget %6u us  os x%u  conversion %6u us\n", dev->name,
+           slot->addr, dev->period_us / 1000, dev->conversion_us, 1u << (os - 1), conv_us);
+
+    dev->ctx = slot;
+    dev->conversion_us = conv_us;
+    return 0;
+}
+
+static void run(bool serial)
+{
+    struct bus_sched sched;
+    uint32_t settle_us = 0;
+
+    /* let conversions left over from the previous run finish */
+    for (size_t i = 0; i < ARRAY_SIZE(devs); i++) {
+        if (devs[i].conversion_us > settle_us) settle_us = devs[i].conversion_us;
+    }
+    k_usleep(settle_us);
+
+    bus_sched_init(&sched, devs, ARRAY_SIZE(devs), serial);
+    bus_sched_run(&sched, CONFIG_BENCH_SECONDS * 1000);
+
+    printk("\n");
+    bus_sched_print_stats(&sched);
+
+    for (size_t i = 0; i < ARRAY_SIZE(slots); i++) {
+        const struct bme680_data *d = &slots[i].last;
+
+        printk("  %-8s last %d.%02d C %u Pa %u.%03u %%RH\n", devs[i].name, d->temp / 100,
+               abs(d->temp % 100), d->press, d->hum / 1000, d->hum % 1000);
+    }
+}
+
+int main(void)
+{
+    printk("bus schedule, %u sensors:\n", (unsigned)ARRAY_SIZE(devs));
+    for (size_t i = 0; i < ARRAY_SIZE(devs); i++) {
+        if (setup(&devs[i], &slots[i]) != 0) return -1;
+    }
+
+    run(false);
+#ifdef CONFIG_BENCH_SERIAL
+    run(true);
+#endif
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include "adaptive_rate.h"
+
+#define SLOPE_SHIFT   2     // slope EWMA weight 1/4
+#define NOISE_SHIFT   3     // noise EWMA weight 1/8
+#define NOISE_K       4     // residual beyond 4x noise + tolerance = transient
+#define NOISE_FLOOR   (1 << 8)  // never assume less than 0.01 C of noise
+
+static inline int32_t iabs(int32_t v)
+{
+    return v < 0 ? -v : v;
+}
+
+static inline uint32_t clamp_u32(uint32_t v, uint32_t lo, uint32_t hi)
+{
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+void adaptive_rate_init(struct adaptive_rate *ar, const struct adaptive_rate_cfg *cfg)
+{
+    *ar = (struct adaptive_rate){ .cfg = *cfg };
+    /* the interval divides the noise into a slope */
+    if (ar->cfg.min_interval_ms < 1) ar->cfg.min_interval_ms = 1;
+    if (ar->cfg.max_interval_ms < ar->cfg.min_interval_ms) {
+        ar->cfg.max_interval_ms = ar->cfg.min_interval_ms;
+    }
+    if (ar->cfg.tolerance < 1) ar->cfg.tolerance = 1;
+
+    ar->noise_q8 = NOISE_FLOOR;
+    ar->interval_ms = ar->cfg.min_interval_ms;
+}
+
+uint32_t adaptive_rate_update(struct adaptive_rate *ar, uint32_t t_ms, int32_t value)
+{
+    const struct adaptive_rate_cfg *cfg = &ar->cfg;
+    uint32_t dt = t_ms - ar->t_prev_ms;
+
+    if (!ar->have_prev || dt == 0) {
+        ar->have_prev = true;
+        ar->t_prev_ms = t_ms;
+        ar->v_prev = value;
+        return ar->interval_ms;
+    }
+
+    /* residual against a straight-line prediction from the last sample */
+    int32_t predicted = ar->v_prev + (int32_t)(((int64_t)ar->slope_q8 * dt / 1000) >> 8);
+    int32_t resid = value - predicted;
+    int32_t inst_slope_q8 = (int32_t)(((int64_t)(value - ar->v_prev) << 8) * 1000 / dt);
+
+    ar->t_prev_ms = t_ms;
+    ar->v_prev = value;
+
+    if ((int64_t)iabs(resid) << 8 > (int64_t)NOISE_K * ar->noise_q8 + ((int64_t)cfg->tolerance << 8)) {
+        /* transient: follow it at full rate, and do not let it inflate the noise */
+        ar->slope_q8 = inst_slope_q8;
+        ar->transients++;
+        ar->interval_ms = cfg->min_interval_ms;
+        return ar->interval_ms;
+    }
+
+    ar->slope_q8 += (inst_slope_q8 - ar->slope_q8) >> SLOPE_SHIFT;
+    ar->noise_q8 += ((iabs(resid) << 8) - ar->noise_q8) >> NOISE_SHIFT;
+    if (ar->noise_q8 < NOISE_FLOOR) ar->noise_q8 = NOISE_FLOOR;
+
+    /* slopes the noise alone could produce over one interval count as flat */
+    int64_t slope = iabs(ar->slope_q8);
+    int64_t noise_slope = (int64_t)ar->noise_q8 * 1000 / ar->interval_ms;
+    slope = slope > noise_slope ? slope - noise_slope : 0;
+
+    uint32_t target;
+    if (slope == 0) {
+        target = cfg->max_interval_ms;
+    } else {
+        int64_t t = ((int64_t)cfg->tolerance << 8) * 1000 / slope;
+        target = t > cfg->max_interval_ms ? cfg->max_interval_ms : (uint32_t)t;
+    }
+
+    /* back off gradually, speed up at once */
+    if (target > ar->interval_ms * 2) target = ar->interval_ms * 2;
+
+    ar->interval_ms = clamp_u32(target, cfg->min_interval_ms, cfg->max_interval_ms);
+    return ar->interval_ms;
+}
@@ -0,0 +1,47 @@
+#ifndef ADAPTIVE_RATE_H
+#define ADAPTIVE_RATE_H
+
+/*
+ * Adaptive sample-rate controller.
+ *
+ * Fed with every sample, it tracks the rate of change (EWMA slope) and a
+ * noise estimate (EWMA of the prediction residual) and picks the next
+ * sampling interval so that the signal moves by about `tolerance`
+ * between samples:
+ *   - slopes within the noise floor count as flat, so a stable but noisy
+ *     signal backs off to max_interval_ms;
+ *   - the interval grows by at most 2x per sample, but shrinks at once;
+ *   - a residual well outside the noise band (a transient) drops straight
+ *     to min_interval_ms.
+ * max_interval_ms is the guaranteed staleness bound.
+ *
+ * Plain C with integer math only, so the host benchmark in
+ * tools/rate_bench builds it unchanged.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct adaptive_rate_cfg {
+    uint32_t min_interval_ms;
+    uint32_t max_interval_ms;   // maximum staleness
+    int32_t  tolerance;         // allowed change between samples, 0.01 C
+};
+
+struct adaptive_rate {
+    struct adaptive_rate_cfg cfg;
+    bool     have_prev;
+    uint32_t t_prev_ms;
+    int32_t  v_prev;
+    int32_t  slope_q8;          // 0.01 C per second, Q8
+    int32_t  noise_q8;          // 0.01 C, Q8
+    uint32_t interval_ms;
+    uint32_t transients;
+};
+
+void adaptive_rate_init(struct adaptive_rate *ar, const struct adaptive_rate_cfg *cfg);
+
+/* feed the sample taken at t_ms; returns the interval until the next one */
+uint32_t adaptive_rate_update(struct adaptive_rate *ar, uint32_t t_ms, int32_t value);
+
+#endif /* ADAPTIVE_RATE_H */
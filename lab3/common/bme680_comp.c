@@ -0,0 +1,192 @@
+#include "bme680_comp.h"
+
+/* Integer compensation as in the Bosch BME68x reference code */
+
+static inline uint16_t u16le(const uint8_t *b) { return (uint16_t)(b[0] | (b[1] << 8)); }
+
+/* ===================== Parsing ===================== */
+void bme680_calib_parse(struct bme680_calib *c, const uint8_t *b1, const uint8_t *b2,
+                        const uint8_t *b3)
+{
+    /* b1 = 0x89.., b2 = 0xE1.., b3 = 0x00.. */
+    c->par_t2  = (int16_t)u16le(&b1[0x8A - 0x89]);
+    c->par_t3  = (int8_t)b1[0x8C - 0x89];
+    c->par_p1  = u16le(&b1[0x8E - 0x89]);
+    c->par_p2  = (int16_t)u16le(&b1[0x90 - 0x89]);
+    c->par_p3  = (int8_t)b1[0x92 - 0x89];
+    c->par_p4  = (int16_t)u16le(&b1[0x94 - 0x89]);
+    c->par_p5  = (int16_t)u16le(&b1[0x96 - 0x89]);
+    c->par_p7  = (int8_t)b1[0x98 - 0x89];
+    c->par_p6  = (int8_t)b1[0x99 - 0x89];
+    c->par_p8  = (int16_t)u16le(&b1[0x9C - 0x89]);
+    c->par_p9  = (int16_t)u16le(&b1[0x9E - 0x89]);
+    c->par_p10 = b1[0xA0 - 0x89];
+
+    c->par_h2  = (uint16_t)((b2[0xE1 - 0xE1] << 4) | (b2[0xE2 - 0xE1] >> 4));
+    c->par_h1  = (uint16_t)((b2[0xE3 - 0xE1] << 4) | (b2[0xE2 - 0xE1] & 0x0F));
+    c->par_h3  = (int8_t)b2[0xE4 - 0xE1];
+    c->par_h4  = (int8_t)b2[0xE5 - 0xE1];
+    c->par_h5  = (int8_t)b2[0xE6 - 0xE1];
+    c->par_h6  = b2[0xE7 - 0xE1];
+    c->par_h7  = (int8_t)b2[0xE8 - 0xE1];
+    c->par_t1  = u16le(&b2[0xE9 - 0xE1]);
+    c->par_g2  = (int16_t)u16le(&b2[0xEB - 0xE1]);
+    c->par_g1  = (int8_t)b2[0xED - 0xE1];
+    c->par_g3  = (int8_t)b2[0xEE - 0xE1];
+
+    c->res_heat_val   = (int8_t)b3[0x00];
+    c->res_heat_range = (b3[0x02] & 0x30) >> 4;
+    c->range_sw_err   = (int8_t)(b3[0x04] & 0xF0) >> 4;
+}
+
+void bme680_adc_parse(struct bme680_adc *adc, const uint8_t *f)
+{
+    /* f[0] = meas_status_0 (0x1D), f[2] = press_msb (0x1F) */
+    adc->status    = f[0];
+    adc->press     = ((uint32_t)f[2] << 12) | ((uint32_t)f[3] << 4) | (f[4] >> 4);
+    adc->temp      = ((uint32_t)f[5] << 12) | ((uint32_t)f[6] << 4) | (f[7] >> 4);
+    adc->hum       = (uint16_t)((f[8] << 8) | f[9]);
+    adc->gas       = (uint16_t)((f[13] << 2) | (f[14] >> 6));
+    adc->gas_range = f[14] & 0x0F;
+    adc->gas_valid = (f[14] & BME680_GAS_VALID) != 0;
+    adc->heat_stab = (f[14] & BME680_HEAT_STAB) != 0;
+}
+
+/* ===================== Compensation ===================== */
+int32_t bme680_comp_temp(const struct bme680_calib *c, uint32_t adc, int32_t *t_fine)
+{
+    int32_t var1 = ((int32_t)adc >> 3) - ((int32_t)c->par_t1 << 1);
+    int32_t var2 = (var1 * (int32_t)c->par_t2) >> 11;
+    int32_t var3 = ((var1 >> 1) * (var1 >> 1)) >> 12;
+    var3 = (var3 * ((int32_t)c->par_t3 << 4)) >> 14;
+
+    *t_fine = var2 + var3;
+    return ((*t_fine * 5) + 128) >> 8;
+}
+
+uint32_t bme680_comp_press(const struct bme680_calib *c, uint32_t adc, int32_t t_fine)
+{
+    int32_t var1 = (t_fine >> 1) - 64000;
+    int32_t var2 = ((((var1 >> 2) * (var1 >> 2)) >> 11) * (int32_t)c->par_p6) >> 2;
+    var2 = var2 + ((var1 * (int32_t)c->par_p5) << 1);
+    var2 = (var2 >> 2) + ((int32_t)c->par_p4 << 16);
+    var1 = (((((var1 >> 2) * (var1 >> 2)) >> 13) * ((int32_t)c->par_p3 << 5)) >> 3) +
+           (((int32_t)c->par_p2 * var1) >> 1);
+    var1 = var1 >> 18;
+    var1 = ((32768 + var1) * (int32_t)c->par_p1) >> 15;
+    if (var1 == 0) return 0;
+
+    int32_t p = 1048576 - (int32_t)adc;
+    p = (int32_t)((p - (var2 >> 12)) * (uint32_t)3125);
+    if (p >= (int32_t)0x40000000) {
+        p = (p / var1) << 1;
+    } else {
+        p = (p << 1) / var1;
+    }
+
+    var1 = ((int32_t)c->par_p9 * (int32_t)(((p >> 3) * (p >> 3)) >> 13)) >> 12;
+    var2 = ((p >> 2) * (int32_t)c->par_p8) >> 13;
+    int32_t var3 = ((p >> 8) * (p >> 8) * (p >> 8) * (int32_t)c->par_p10) >> 17;
+    p = p + ((var1 + var2 + var3 + ((int32_t)c->par_p7 << 7)) >> 4);
+    return (uint32_t)p;
+}
+
+uint32_t bme680_comp_hum(const struct bme680_calib *c, uint16_t adc, int32_t t_fine)
+{
+    int32_t temp_scaled = ((t_fine * 5) + 128) >> 8;
+    int32_t var1 = (int32_t)(adc - ((int32_t)c->par_h1 * 16)) -
+                   (((temp_scaled * (int32_t)c->par_h3) / 100) >> 1);
+    int32_t var2 = ((int32_t)c->par_h2 *
+                    (((temp_scaled * (int32_t)c->par_h4) / 100) +
+                     (((temp_scaled * ((temp_scaled * (int32_t)c->par_h5) / 100)) >> 6) / 100) +
+                     (1 << 14))) >> 10;
+    int32_t var3 = var1 * var2;
+    int32_t var4 = (int32_t)c->par_h6 << 7;
+    var4 = (var4 + ((temp_scaled * (int32_t)c->par_h7) / 100)) >> 4;
+    int32_t var5 = ((var3 >> 14) * (var3 >> 14)) >> 10;
+    int32_t var6 = (var4 * var5) >> 1;
+    int32_t h = (((var3 + var6) >> 10) * 1000) >> 12;
+
+    if (h > 100000) h = 100000;
+    if (h < 0) h = 0;
+    return (uint32_t)h;
+}
+
+uint32_t bme680_comp_gas(const struct bme680_calib *c, uint16_t adc, uint8_t range)
+{
+    static const uint32_t lookup1[16] = {
+        2147483647u, 2147483647u, 2147483647u, 2147483647u,
+        2147483647u, 2126008810u, 2147483647u, 2130303777u,
+        2147483647u, 2147483647u, 2143188679u, 2136746228u,
+        2147483647u, 2126008810u, 2147483647u, 2147483647u,
+    };
+    static const uint32_t lookup2[16] = {
+        4096000000u, 2048000000u, 1024000000u, 512000000u,
+        255744255u,  127110228u,  64000000u,   32258064u,
+        16016016u,   8000000u,    4000000u,    2000000u,
+        1000000u,    500000u,     250000u,     125000u,
+    };
+
+    range &= 0x0F;
+    int64_t var1 = ((1340 + (5 * (int64_t)c->range_sw_err)) * (int64_t)lookup1[range]) >> 16;
+    int64_t var2 = ((int64_t)adc << 15) - 16777216 + var1;
+    int64_t var3 = ((int64_t)lookup2[range] * var1) >> 9;
+    if (var2 == 0) return 0;
+
+    return (uint32_t)((var3 + (var2 >> 1)) / var2);
+}
+
+void bme680_compensate(const struct bme680_calib *c, const struct bme680_adc *adc,
+                       struct bme680_data *out)
+{
+    int32_t t_fine;
+
+    out->temp  = bme680_comp_temp(c, adc->temp, &t_fine);
+    out->press = bme680_comp_press(c, adc->press, t_fine);
+    out->hum   = bme680_comp_hum(c, adc->hum, t_fine);
+    out->gas   = (adc->gas_valid && adc->heat_stab) ? bme680_comp_gas(c, adc->gas, adc->gas_range) : 0;
+}
+
+/* ===================== Heater ===================== */
+uint8_t bme680_res_heat(const struct bme680_calib *c, uint16_t target_c, int32_t amb_c)
+{
+    if (target_c > 400) target_c = 400;   // datasheet maximum
+
+    int32_t var1 = ((amb_c * c->par_g3) / 1000) * 256;
+    int32_t var2 = (c->par_g1 + 784) *
+                   (((((c->par_g2 + 154009) * (int32_t)target_c * 5) / 100) + 3276800) / 10);
+    int32_t var3 = var1 + (var2 / 2);
+    int32_t var4 = var3 / (c->res_heat_range + 4);
+    int32_t var5 = (131 * c->res_heat_val) + 65536;
+    int32_t res_x100 = ((var4 / var5) - 250) * 34;
+
+    return (uint8_t)((res_x100 + 50) / 100);
+}
+
+uint8_t bme680_gas_wait(uint16_t dur_ms)
+{
+    uint8_t factor = 0;
+
+    if (dur_ms >= 0xFC0) return 0xFF;     // 4032 ms maximum
+    while (dur_ms > 0x3F) {
+        dur_ms /= 4;
+        factor++;
+    }
+    return (uint8_t)(dur_ms + factor * 64);
+}
+
+uint32_t bme680_gas_wait_ms(uint8_t reg)
+{
+    return (uint32_t)(reg & 0x3F) << (2 * (reg >> 6));
+}
+
+uint32_t bme680_tph_duration_us(uint8_t os_t, uint8_t os_p, uint8_t os_h)
+{
+    static const uint8_t cycles[6] = { 0, 1, 2, 4, 8, 16 };
+
+    uint32_t us = (cycles[os_t % 6] + cycles[os_p % 6] + cycles[os_h % 6]) * 1963u;
+    us += 477 * 4;      // TPH switching
+    us += 477 * 5;      // gas measurement
+    us += 1000;         // wake-up from sleep
+    return us;
+}
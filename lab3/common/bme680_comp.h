@@ -0,0 +1,145 @@
+#ifndef BME680_COMP_H
+#define BME680_COMP_H
+
+/*
+ * BME680 register map, calibration parsing and Bosch integer
+ * compensation. Plain C without Zephyr headers: shared by the
+ * register-level driver (bme680_raw.c) and the host sensor model
+ * (bme680_model.c).
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ===================== Registers ===================== */
+#define BME680_REG_STATUS0      0x1D    // meas_status_0, start of field data
+#define BME680_REG_TEMP_MSB     0x22    // temp_msb, temp_lsb, temp_xlsb
+#define BME680_REG_IDAC_HEAT0   0x50
+#define BME680_REG_RES_HEAT0    0x5A
+#define BME680_REG_GAS_WAIT0    0x64
+#define BME680_REG_CTRL_GAS0    0x70
+#define BME680_REG_CTRL_GAS1    0x71
+#define BME680_REG_CTRL_HUM     0x72
+#define BME680_REG_CTRL_MEAS    0x74
+#define BME680_REG_CONFIG       0x75
+#define BME680_REG_CHIP_ID      0xD0
+#define BME680_REG_RESET        0xE0
+
+#define BME680_CHIP_ID          0x61
+#define BME680_HEATER_SLOTS     10
+
+#define BME680_STATUS_NEW_DATA  0x80
+#define BME680_STATUS_GAS_MEAS  0x40
+#define BME680_STATUS_MEASURING 0x20
+#define BME680_GAS_VALID        0x20
+#define BME680_HEAT_STAB        0x10
+#define BME680_RUN_GAS          0x10
+#define BME680_MODE_SLEEP       0x00
+#define BME680_MODE_FORCED      0x01
+
+/* calibration blocks, read in three bursts */
+#define BME680_CALIB1_REG       0x89
+#define BME680_CALIB1_LEN       25
+#define BME680_CALIB2_REG       0xE1
+#define BME680_CALIB2_LEN       16
+#define BME680_CALIB3_REG       0x00
+#define BME680_CALIB3_LEN       5
+
+/* field data: meas_status_0 .. gas_r_lsb */
+#define BME680_FIELD_LEN        15
+
+/* oversampling setting: 0 = skipped, 1..5 = x1, x2, x4, x8, x16 */
+enum bme680_os {
+    BME680_OS_NONE = 0,
+    BME680_OS_1X,
+    BME680_OS_2X,
+    BME680_OS_4X,
+    BME680_OS_8X,
+    BME680_OS_16X,
+};
+
+/* IIR filter coefficient: 0 = off, 1..7 = 1, 3, 7, 15, 31, 63, 127 */
+enum bme680_filter {
+    BME680_FILTER_OFF = 0,
+    BME680_FILTER_1,
+    BME680_FILTER_3,
+    BME680_FILTER_7,
+    BME680_FILTER_15,
+    BME680_FILTER_31,
+    BME680_FILTER_63,
+    BME680_FILTER_127,
+};
+
+struct bme680_calib {
+    uint16_t par_t1;
+    int16_t  par_t2;
+    int8_t   par_t3;
+    uint16_t par_p1;
+    int16_t  par_p2;
+    int8_t   par_p3;
+    int16_t  par_p4;
+    int16_t  par_p5;
+    int8_t   par_p6;
+    int8_t   par_p7;
+    int16_t  par_p8;
+    int16_t  par_p9;
+    uint8_t  par_p10;
+    uint16_t par_h1;
+    uint16_t par_h2;
+    int8_t   par_h3;
+    int8_t   par_h4;
+    int8_t   par_h5;
+    uint8_t  par_h6;
+    int8_t   par_h7;
+    int8_t   par_g1;
+    int16_t  par_g2;
+    int8_t   par_g3;
+    uint8_t  res_heat_range;
+    int8_t   res_heat_val;
+    int8_t   range_sw_err;
+};
+
+/* ADC words extracted from the field data block */
+struct bme680_adc {
+    uint8_t  status;
+    uint32_t temp;
+    uint32_t press;
+    uint16_t hum;
+    uint16_t gas;
+    uint8_t  gas_range;
+    bool     gas_valid;
+    bool     heat_stab;
+};
+
+struct bme680_data {
+    int32_t  temp;      // 0.01 C
+    uint32_t press;     // Pa
+    uint32_t hum;       // 0.001 %RH
+    uint32_t gas;       // ohm, 0 if no valid gas reading
+};
+
+void bme680_calib_parse(struct bme680_calib *c, const uint8_t *b1, const uint8_t *b2,
+                        const uint8_t *b3);
+
+void bme680_adc_parse(struct bme680_adc *adc, const uint8_t *field);
+
+/* t_fine is the shared intermediate the P and H formulas need */
+int32_t  bme680_comp_temp(const struct bme680_calib *c, uint32_t adc, int32_t *t_fine);
+uint32_t bme680_comp_press(const struct bme680_calib *c, uint32_t adc, int32_t t_fine);
+uint32_t bme680_comp_hum(const struct bme680_calib *c, uint16_t adc, int32_t t_fine);
+uint32_t bme680_comp_gas(const struct bme680_calib *c, uint16_t adc, uint8_t range);
+
+void bme680_compensate(const struct bme680_calib *c, const struct bme680_adc *adc,
+                       struct bme680_data *out);
+
+/* res_heat_x for a heater target (C) at ambient temperature amb (C) */
+uint8_t bme680_res_heat(const struct bme680_calib *c, uint16_t target_c, int32_t amb_c);
+
+/* gas_wait_x encoding and decoding, ms */
+uint8_t  bme680_gas_wait(uint16_t dur_ms);
+uint32_t bme680_gas_wait_ms(uint8_t reg);
+
+/* TPH conversion time in us for the given oversampling settings */
+uint32_t bme680_tph_duration_us(uint8_t os_t, uint8_t os_p, uint8_t os_h);
+
+#endif /* BME680_COMP_H */
@@ -0,0 +1,87 @@
+/*
+ * I2C emulator for the BME680 on native_sim, backed by the register
+ * model in bme680_model.c. Binds to every "bosch,bme680" node on an
+ * emulated controller, the same nodes the in-tree driver uses, so the
+ * driver and the raw-register code both talk to it. Transfers hold the
+ * caller for their time on a CONFIG_APP_BME680_EMUL_BUS_KHZ bus.
+ */
+
+#define DT_DRV_COMPAT bosch_bme680
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/i2c_emul.h>
+#include <errno.h>
+
+#include "bme680_model.h"
+
+struct bme680_emul_data {
+    struct bme680_model model;
+};
+
+static uint64_t now_us(void)
+{
+    return k_ticks_to_us_floor64(k_uptime_ticks());
+}
+
+/* 9 bits per byte, the address byte of every message, start and stop */
+static void bus_time(const struct i2c_msg *msgs, int num_msgs)
+{
+#if CONFIG_APP_BME680_EMUL_BUS_KHZ > 0
+    uint32_t bits = 2;
+
+    for (int i = 0; i < num_msgs; i++) {
+        bits += (msgs[i].len + 1) * 9;
+    }
+    k_busy_wait(DIV_ROUND_UP(bits * 1000, CONFIG_APP_BME680_EMUL_BUS_KHZ));
+#else
+    ARG_UNUSED(msgs);
+    ARG_UNUSED(num_msgs);
+#endif
+}
+
+static int bme680_emul_transfer(const struct emul *target, struct i2c_msg *msgs, int num_msgs,
+                                int addr)
+{
+    struct bme680_emul_data *data = target->data;
+    uint8_t reg = 0;
+
+    ARG_UNUSED(addr);
+
+    bus_time(msgs, num_msgs);
+
+    for (int i = 0; i < num_msgs; i++) {
+        struct i2c_msg *m = &msgs[i];
+
+        if (m->flags & I2C_MSG_READ) {
+            bme680_model_read(&data->model, reg, m->buf, m->len, now_us());
+        } else if (m->len == 1) {
+            reg = m->buf[0];    // register pointer for the read that follows
+        } else {
+            bme680_model_write(&data->model, m->buf, m->len, now_us());
+        }
+    }
+    return 0;
+}
+
+static const struct i2c_emul_api bme680_emul_api = {
+    .transfer = bme680_emul_transfer,
+};
+
+static int bme680_emul_init(const struct emul *target, const struct device *parent)
+{
+    struct bme680_emul_data *data = target->data;
+
+    ARG_UNUSED(parent);
+    bme680_model_init(&data->model);
+    return 0;
+}
+
+#define BME680_EMUL(n)                                                          \
+    static struct bme680_emul_data bme680_emul_data_##n;                        \
+    EMUL_DT_INST_DEFINE(n, bme680_emul_init, &bme680_emul_data_##n, NULL,       \
+                        &bme680_emul_api, NULL)
+
+DT_INST_FOREACH_STATUS_OKAY(BME680_EMUL)
@@ -0,0 +1,306 @@
+#include <string.h>
+
+#include "bme680_model.h"
+
+#define STABLE_MS 20    // heating shorter than this never reaches heat_stab
+
+/* calibration of a typical part, in register order */
+static void put16(uint8_t *regs, uint8_t lsb_reg, uint16_t v)
+{
+    regs[lsb_reg] = (uint8_t)v;
+    regs[lsb_reg + 1] = (uint8_t)(v >> 8);
+}
+
+static void load_calib(struct bme680_model *m)
+{
+    uint8_t *r = m->regs;
+
+    put16(r, 0xE9, 26092);              // par_t1
+    put16(r, 0x8A, 26325);              // par_t2
+    r[0x8C] = 3;                        // par_t3
+    put16(r, 0x8E, 36545);              // par_p1
+    put16(r, 0x90, (uint16_t)-10350);   // par_p2
+    r[0x92] = 88;                       // par_p3
+    put16(r, 0x94, 7137);               // par_p4
+    put16(r, 0x96, (uint16_t)-94);      // par_p5
+    r[0x99] = 30;                       // par_p6
+    r[0x98] = 40;                       // par_p7
+    put16(r, 0x9C, (uint16_t)-2580);    // par_p8
+    put16(r, 0x9E, (uint16_t)-2310);    // par_p9
+    r[0xA0] = 30;                       // par_p10
+
+    /* par_h1 = 763, par_h2 = 1012 share 0xE2 */
+    r[0xE1] = 1012 >> 4;
+    r[0xE2] = (uint8_t)(((1012 & 0x0F) << 4) | (763 & 0x0F));
+    r[0xE3] = 763 >> 4;
+    r[0xE4] = 0;                        // par_h3
+    r[0xE5] = 45;                       // par_h4
+    r[0xE6] = 20;                       // par_h5
+    r[0xE7] = 120;                      // par_h6
+    r[0xE8] = (uint8_t)-100;            // par_h7
+
+    r[0xED] = (uint8_t)-30;             // par_g1
+    put16(r, 0xEB, (uint16_t)-12000);   // par_g2
+    r[0xEE] = 18;                       // par_g3
+    r[0x00] = 40;                       // res_heat_val
+    r[0x02] = 1 << 4;                   // res_heat_range
+    r[0x04] = 0;                        // range_sw_err
+
+    bme680_calib_parse(&m->calib, &r[BME680_CALIB1_REG], &r[BME680_CALIB2_REG],
+                       &r[BME680_CALIB3_REG]);
+}
+
+void bme680_model_init(struct bme680_model *m)
+{
+    memset(m, 0, sizeof(*m));
+    load_calib(m);
+    m->regs[BME680_REG_CHIP_ID] = BME680_CHIP_ID;
+    bme680_model_set_env(m, BME680_MODEL_TEMP, BME680_MODEL_PRESS, BME680_MODEL_HUM,
+                         BME680_MODEL_GAS);
+}
+
+void bme680_model_set_env(struct bme680_model *m, int32_t temp, uint32_t press,
+                          uint32_t hum, uint32_t gas_base)
+{
+    m->temp = temp;
+    m->press = press;
+    m->hum = hum;
+    m->gas_base = gas_base;
+}
+
+/* ===================== Result generation ===================== */
+/*
+ * T, P and H words come from the datasheet's floating-point compensation,
+ * not from bme680_comp.c, so the integer code under test is checked
+ * against an independent reference. t_fine is T * 5120 in both.
+ */
+static double ref_temp(const struct bme680_calib *c, uint32_t adc, double *t_fine)
+{
+    double var1 = ((double)adc / 16384.0 - (double)c->par_t1 / 1024.0) * (double)c->par_t2;
+    double x = (double)adc / 131072.0 - (double)c->par_t1 / 8192.0;
+    double var2 = x * x * ((double)c->par_t3 * 16.0);
+
+    *t_fine = var1 + var2;
+    return *t_fine / 5120.0;
+}
+
+static double ref_press(const struct bme680_calib *c, uint32_t adc, double t_fine)
+{
+    double var1 = t_fine / 2.0 - 64000.0;
+    double var2 = var1 * var1 * ((double)c->par_p6 / 131072.0);
+    double var3;
+
+    var2 = var2 + var1 * (double)c->par_p5 * 2.0;
+    var2 = var2 / 4.0 + (double)c->par_p4 * 65536.0;
+    var1 = ((double)c->par_p3 * var1 * var1 / 16384.0 + (double)c->par_p2 * var1) / 524288.0;
+    var1 = (1.0 + var1 / 32768.0) * (double)c->par_p1;
+
+    double p = 1048576.0 - (double)adc;
+
+    p = (p - var2 / 4096.0) * 6250.0 / var1;
+    var1 = (double)c->par_p9 * p * p / 2147483648.0;
+    var2 = p * ((double)c->par_p8 / 32768.0);
+    var3 = (p / 256.0) * (p / 256.0) * (p / 256.0) * ((double)c->par_p10 / 131072.0);
+    return p + (var1 + var2 + var3 + (double)c->par_p7 * 128.0) / 16.0;
+}
+
+static double ref_hum(const struct bme680_calib *c, uint16_t adc, double t_fine)
+{
+    double t = t_fine / 5120.0;
+    double var1 = (double)adc - ((double)c->par_h1 * 16.0 + (double)c->par_h3 / 2.0 * t);
+    double var2 = var1 * ((double)c->par_h2 / 262144.0 *
+                          (1.0 + (double)c->par_h4 / 16384.0 * t +
+                           (double)c->par_h5 / 1048576.0 * t * t));
+    double var3 = (double)c->par_h6 / 16384.0;
+    double var4 = (double)c->par_h7 / 2097152.0;
+
+    return var2 + (var3 + var4 * t) * var2 * var2;
+}
+
+/* ===================== ADC words from the reference ===================== */
+struct ref_ctx {
+    const struct bme680_calib *c;
+    double t_fine;
+};
+
+static double temp_of(const struct ref_ctx *x, uint32_t adc)
+{
+    double t_fine;
+    return ref_temp(x->c, adc, &t_fine);
+}
+
+/* negated: pressure falls as the ADC word rises */
+static double neg_press_of(const struct ref_ctx *x, uint32_t adc)
+{
+    return -ref_press(x->c, adc, x->t_fine);
+}
+
+static double hum_of(const struct ref_ctx *x, uint32_t adc)
+{
+    return ref_hum(x->c, (uint16_t)adc, x->t_fine);
+}
+
+/* the ADC word in 0..max whose value is nearest want; f rises with the word */
+static uint32_t find_adc(double (*f)(const struct ref_ctx *, uint32_t), const struct ref_ctx *x,
+                         double want, uint32_t max)
+{
+    uint32_t lo = 0, hi = max;
+
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (f(x, mid) < want) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo > 0 && want - f(x, lo - 1) < f(x, lo) - want) lo--;
+    return lo;
+}
+
+static void find_gas_adc(const struct bme680_calib *c, uint32_t want, uint16_t *adc, uint8_t *range)
+{
+    /* the lowest range whose span covers the resistance */
+    for (uint8_t r = 0; r < 16; r++) {
+        uint32_t hi_r = bme680_comp_gas(c, 64, r);
+        uint32_t lo_r = bme680_comp_gas(c, 1000, r);
+        if (want > hi_r || want < lo_r) continue;
+
+        uint32_t lo = 64, hi = 1000;
+        while (lo < hi) {
+            uint32_t mid = (lo + hi) / 2;
+            if (bme680_comp_gas(c, (uint16_t)mid, r) > want) lo = mid + 1;
+            else hi = mid;
+        }
+        *adc = (uint16_t)lo;
+        *range = r;
+        return;
+    }
+    *adc = 1023;
+    *range = 15;
+}
+
+/* heater temperature that res_heat_x corresponds to */
+static uint16_t heater_temp(const struct bme680_model *m, uint8_t res_heat)
+{
+    uint16_t best = 0;
+    int best_err = 256;
+
+    for (uint16_t t = 150; t <= 400; t++) {
+        int err = bme680_res_heat(&m->calib, t, m->temp / 100) - res_heat;
+        if (err < 0) err = -err;
+        if (err < best_err) {
+            best_err = err;
+            best = t;
+        }
+    }
+    return best;
+}
+
+static uint8_t os_of(uint8_t reg_bits)
+{
+    return reg_bits & 0x07;
+}
+
+static uint64_t conversion_us(const struct bme680_model *m)
+{
+    const uint8_t *r = m->regs;
+    uint64_t us = bme680_tph_duration_us(os_of(r[BME680_REG_CTRL_MEAS] >> 5),
+                                         os_of(r[BME680_REG_CTRL_MEAS] >> 2),
+                                         os_of(r[BME680_REG_CTRL_HUM]));
+
+    if (r[BME680_REG_CTRL_GAS1] & BME680_RUN_GAS) {
+        uint8_t slot = r[BME680_REG_CTRL_GAS1] & 0x0F;
+        us += (uint64_t)bme680_gas_wait_ms(r[BME680_REG_GAS_WAIT0 + slot % BME680_HEATER_SLOTS]) * 1000;
+    }
+    return us;
+}
+
+static void finish_conversion(struct bme680_model *m)
+{
+    uint8_t *r = m->regs;
+    uint8_t *f = &r[BME680_REG_STATUS0];
+
+    uint8_t os_t = os_of(r[BME680_REG_CTRL_MEAS] >> 5);
+    uint8_t os_p = os_of(r[BME680_REG_CTRL_MEAS] >> 2);
+    uint8_t os_h = os_of(r[BME680_REG_CTRL_HUM]);
+
+    /* skipped channels read 0x80000 / 0x8000, as on the real part */
+    struct ref_ctx x = { .c = &m->calib };
+    uint32_t t_true = find_adc(temp_of, &x, m->temp / 100.0, (1u << 20) - 1);
+
+    ref_temp(&m->calib, t_true, &x.t_fine);     // P and H need it even without T
+    uint32_t t_adc = os_t ? t_true : 0x80000;
+    uint32_t p_adc = os_p ? find_adc(neg_press_of, &x, -(double)m->press, (1u << 20) - 1) : 0x80000;
+    uint16_t h_adc = os_h ? (uint16_t)find_adc(hum_of, &x, m->hum / 1000.0, 0xFFFF) : 0x8000;
+
+    f[2] = (uint8_t)(p_adc >> 12);
+    f[3] = (uint8_t)(p_adc >> 4);
+    f[4] = (uint8_t)(p_adc << 4);
+    f[5] = (uint8_t)(t_adc >> 12);
+    f[6] = (uint8_t)(t_adc >> 4);
+    f[7] = (uint8_t)(t_adc << 4);
+    f[8] = (uint8_t)(h_adc >> 8);
+    f[9] = (uint8_t)h_adc;
+
+    uint8_t gas1 = r[BME680_REG_CTRL_GAS1];
+    uint8_t slot = (gas1 & 0x0F) % BME680_HEATER_SLOTS;
+    f[13] = 0;
+    f[14] = 0;
+    if (gas1 & BME680_RUN_GAS) {
+        uint16_t heat_c = heater_temp(m, r[BME680_REG_RES_HEAT0 + slot]);
+        uint32_t wait_ms = bme680_gas_wait_ms(r[BME680_REG_GAS_WAIT0 + slot]);
+        uint32_t ohm = heat_c ? (uint32_t)((uint64_t)m->gas_base * 300 / heat_c) : m->gas_base;
+        uint16_t adc;
+        uint8_t range;
+
+        find_gas_adc(&m->calib, ohm, &adc, &range);
+        f[13] = (uint8_t)(adc >> 2);
+        f[14] = (uint8_t)((adc << 6) | BME680_GAS_VALID | range |
+                          (wait_ms >= STABLE_MS ? BME680_HEAT_STAB : 0));
+    }
+
+    f[0] = BME680_STATUS_NEW_DATA | slot;
+    r[BME680_REG_CTRL_MEAS] &= ~0x03;     // back to sleep mode
+    m->converting = false;
+    m->conversions++;
+}
+
+static void update(struct bme680_model *m, uint64_t now_us)
+{
+    if (m->converting && now_us >= m->done_us) {
+        finish_conversion(m);
+    }
+}
+
+/* ===================== Bus side ===================== */
+void bme680_model_write(struct bme680_model *m, const uint8_t *buf, size_t len, uint64_t now_us)
+{
+    update(m, now_us);
+
+    for (size_t i = 0; i + 1 < len; i += 2) {
+        uint8_t reg = buf[i], val = buf[i + 1];
+
+        if (reg == BME680_REG_RESET && val == 0xB6) {
+            bme680_model_init(m);
+            continue;
+        }
+        m->regs[reg] = val;
+
+        if (reg == BME680_REG_CTRL_MEAS && (val & 0x03) == BME680_MODE_FORCED) {
+            uint8_t status = BME680_STATUS_MEASURING;
+            if (m->regs[BME680_REG_CTRL_GAS1] & BME680_RUN_GAS) status |= BME680_STATUS_GAS_MEAS;
+
+            m->regs[BME680_REG_STATUS0] = status;
+            m->converting = true;
+            m->done_us = now_us + conversion_us(m);
+        }
+    }
+}
+
+void bme680_model_read(struct bme680_model *m, uint8_t reg, uint8_t *buf, size_t len,
+                       uint64_t now_us)
+{
+    update(m, now_us);
+
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = m->regs[(uint8_t)(reg + i)];
+    }
+}
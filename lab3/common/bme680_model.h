@@ -0,0 +1,55 @@
+#ifndef BME680_MODEL_H
+#define BME680_MODEL_H
+
+/*
+ * Register-level model of a BME680 for emulation: register file,
+ * calibration contents, forced-mode conversion timing and result words
+ * generated from a configurable environment. T/P/H words invert the
+ * datasheet's floating-point compensation, independent of the integer
+ * code in bme680_comp.c. Plain C on a caller-supplied clock in us, so it
+ * backs both host tools and Zephyr I2C emulators.
+ *
+ * Register writes take the sensor's register/value pair format; reads
+ * auto-increment. The IIR filter is accepted but not modelled.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bme680_comp.h"
+
+struct bme680_model {
+    uint8_t regs[256];
+    struct bme680_calib calib;
+
+    bool converting;
+    uint64_t done_us;
+    uint32_t conversions;
+
+    /* environment the next conversion reports */
+    int32_t  temp;      // 0.01 C
+    uint32_t press;     // Pa
+    uint32_t hum;       // 0.001 %RH
+    uint32_t gas_base;  // ohm with the heater at 300 C
+};
+
+/* environment after bme680_model_init() */
+#define BME680_MODEL_TEMP   2250
+#define BME680_MODEL_PRESS  101325
+#define BME680_MODEL_HUM    45000
+#define BME680_MODEL_GAS    50000
+
+void bme680_model_init(struct bme680_model *m);
+
+void bme680_model_set_env(struct bme680_model *m, int32_t temp, uint32_t press,
+                          uint32_t hum, uint32_t gas_base);
+
+/* one I2C write transaction: pairs of register, value */
+void bme680_model_write(struct bme680_model *m, const uint8_t *buf, size_t len, uint64_t now_us);
+
+/* one I2C burst read starting at reg */
+void bme680_model_read(struct bme680_model *m, uint8_t reg, uint8_t *buf, size_t len,
+                       uint64_t now_us);
+
+#endif /* BME680_MODEL_H */
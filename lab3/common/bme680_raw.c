@@ -0,0 +1,100 @@
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/i2c.h>
+#include <errno.h>
+
+#include "bme680_raw.h"
+
+static int rdN(struct bme680_raw *dev, uint8_t start_reg, uint8_t *buf, size_t len)
+{
+    return i2c_burst_read(dev->i2c, dev->addr, start_reg, buf, len);
+}
+
+/* pairs = { reg0, val0, reg1, val1, ... } in one transaction */
+static int wr_pairs(struct bme680_raw *dev, const uint8_t *pairs, size_t len)
+{
+    return i2c_write(dev->i2c, pairs, len, dev->addr);
+}
+
+int bme680_raw_init(struct bme680_raw *dev, const struct device *i2c, uint16_t addr)
+{
+    uint8_t id;
+    uint8_t b1[BME680_CALIB1_LEN], b2[BME680_CALIB2_LEN], b3[BME680_CALIB3_LEN];
+
+    dev->i2c = i2c;
+    dev->addr = addr;
+
+    if (i2c_reg_read_byte(i2c, addr, BME680_REG_CHIP_ID, &id) != 0) return -EIO;
+    if (id != BME680_CHIP_ID) return -ENODEV;
+
+    if (rdN(dev, BME680_CALIB1_REG, b1, sizeof(b1)) != 0 ||
+        rdN(dev, BME680_CALIB2_REG, b2, sizeof(b2)) != 0 ||
+        rdN(dev, BME680_CALIB3_REG, b3, sizeof(b3)) != 0) {
+        return -EIO;
+    }
+    bme680_calib_parse(&dev->calib, b1, b2, b3);
+
+    /* lab3/part1 defaults: temperature only, x1 */
+    const struct bme680_raw_cfg cfg = { BME680_OS_1X, BME680_OS_NONE, BME680_OS_NONE, 0 };
+    return bme680_raw_configure(dev, &cfg);
+}
+
+int bme680_raw_configure(struct bme680_raw *dev, const struct bme680_raw_cfg *cfg)
+{
+    const uint8_t pairs[] = {
+        BME680_REG_CTRL_HUM, cfg->os_h & 0x07,
+        BME680_REG_CONFIG, (uint8_t)((cfg->filter & 0x07) << 2),
+    };
+
+    int rc = wr_pairs(dev, pairs, sizeof(pairs));
+    if (rc == 0) dev->cfg = *cfg;
+    return rc;
+}
+
+int bme680_raw_set_heater(struct bme680_raw *dev, uint8_t slot, uint16_t target_c,
+                          uint16_t dur_ms, int32_t amb_c)
+{
+    if (slot >= BME680_HEATER_SLOTS) return -EINVAL;
+
+    const uint8_t pairs[] = {
+        BME680_REG_RES_HEAT0 + slot, bme680_res_heat(&dev->calib, target_c, amb_c),
+        BME680_REG_GAS_WAIT0 + slot, bme680_gas_wait(dur_ms),
+    };
+    return wr_pairs(dev, pairs, sizeof(pairs));
+}
+
+int bme680_raw_trigger(struct bme680_raw *dev, int slot)
+{
+    uint8_t gas1 = slot < 0 ? 0 : (BME680_RUN_GAS | (slot & 0x0F));
+    uint8_t meas = (uint8_t)(((dev->cfg.os_t & 0x07) << 5) | ((dev->cfg.os_p & 0x07) << 2) |
+                             BME680_MODE_FORCED);
+
+    /* ctrl_meas last: writing the mode starts the conversion */
+    const uint8_t pairs[] = {
+        BME680_REG_CTRL_GAS1, gas1,
+        BME680_REG_CTRL_MEAS, meas,
+    };
+    return wr_pairs(dev, pairs, sizeof(pairs));
+}
+
+int bme680_raw_read(struct bme680_raw *dev, struct bme680_data *out)
+{
+    uint8_t field[BME680_FIELD_LEN];
+    struct bme680_adc adc;
+
+    /* status and all results in one burst */
+    if (rdN(dev, BME680_REG_STATUS0, field, sizeof(field)) != 0) return -EIO;
+
+    bme680_adc_parse(&adc, field);
+    if (!(adc.status & BME680_STATUS_NEW_DATA)) return -EBUSY;
+
+    bme680_compensate(&dev->calib, &adc, out);
+    return 0;
+}
+
+uint32_t bme680_raw_duration_us(const struct bme680_raw *dev, uint16_t heat_ms)
+{
+    /* the heater runs for the encoded duration, which rounds down */
+    uint32_t heat_us = heat_ms ? bme680_gas_wait_ms(bme680_gas_wait(heat_ms)) * 1000 : 0;
+
+    return bme680_tph_duration_us(dev->cfg.os_t, dev->cfg.os_p, dev->cfg.os_h) + heat_us;
+}
@@ -0,0 +1,52 @@
+#ifndef BME680_RAW_H
+#define BME680_RAW_H
+
+/*
+ * Register-level BME680 access over Zephyr I2C, the lab3/part1 way but
+ * with every channel: oversampling for T/P/H, the IIR filter and the
+ * ten gas heater set-points.
+ *
+ * Multi-register writes use the BME680's register/value pair format, so
+ * a trigger (ctrl_gas_1 + ctrl_meas) or a heater set-point (res_heat_x +
+ * gas_wait_x) is a single I2C transaction.
+ */
+
+#include <zephyr/device.h>
+#include <stdint.h>
+
+#include "bme680_comp.h"
+
+struct bme680_raw_cfg {
+    uint8_t os_t;       // enum bme680_os
+    uint8_t os_p;
+    uint8_t os_h;
+    uint8_t filter;     // enum bme680_filter
+};
+
+struct bme680_raw {
+    const struct device *i2c;
+    uint16_t addr;
+    struct bme680_calib calib;
+    struct bme680_raw_cfg cfg;
+};
+
+/* check the chip id and read the calibration */
+int bme680_raw_init(struct bme680_raw *dev, const struct device *i2c, uint16_t addr);
+
+/* oversampling and filter; applied by the next trigger */
+int bme680_raw_configure(struct bme680_raw *dev, const struct bme680_raw_cfg *cfg);
+
+/* program heater set-point `slot` (0..9) for target_c, given ambient amb_c */
+int bme680_raw_set_heater(struct bme680_raw *dev, uint8_t slot, uint16_t target_c,
+                          uint16_t dur_ms, int32_t amb_c);
+
+/* start one forced measurement using heater `slot`, or no gas if slot < 0 */
+int bme680_raw_trigger(struct bme680_raw *dev, int slot);
+
+/* read and compensate the result; -EBUSY while the conversion runs */
+int bme680_raw_read(struct bme680_raw *dev, struct bme680_data *out);
+
+/* expected conversion time: TPH plus heater duration */
+uint32_t bme680_raw_duration_us(const struct bme680_raw *dev, uint16_t heat_ms);
+
+#endif /* BME680_RAW_H */
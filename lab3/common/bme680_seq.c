@@ -0,0 +1,89 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <errno.h>
+#include <string.h>
+
+#include "bme680_seq.h"
+
+#define POLL_US     500     // result not ready yet: retry after this long
+#define POLL_MAX    20
+#define AMB_DEFAULT 25      // C, until the first measurement
+
+static inline uint32_t elapsed_us(uint32_t start_cyc)
+{
+    return k_cyc_to_us_floor32(k_cycle_get_32() - start_cyc);
+}
+
+static int load_profile(struct bme680_seq *seq, size_t idx, uint8_t slot)
+{
+    const struct bme680_heater_profile *p = &seq->profiles[idx];
+
+    if (p->temp_c == 0) return 0;
+    return bme680_raw_set_heater(seq->dev, slot, p->temp_c, p->dur_ms, seq->amb_c);
+}
+
+int bme680_seq_start(struct bme680_seq *seq, struct bme680_raw *dev,
+                     const struct bme680_heater_profile *profiles, size_t count)
+{
+    if (count == 0 || count > BME680_SEQ_MAX_PROFILES) return -EINVAL;
+
+    memset(seq, 0, sizeof(*seq));
+    seq->dev = dev;
+    seq->profiles = profiles;
+    seq->count = count;
+    seq->amb_c = AMB_DEFAULT;
+
+    return load_profile(seq, 0, 0);
+}
+
+int bme680_seq_step(struct bme680_seq *seq, struct bme680_data *out, size_t *profile)
+{
+    size_t idx = seq->next;
+    const struct bme680_heater_profile *p = &seq->profiles[idx];
+    uint32_t start = k_cycle_get_32();
+
+    int rc = bme680_raw_trigger(seq->dev, p->temp_c ? seq->slot : -1);
+    if (rc) return rc;
+
+    uint32_t dur_us = bme680_raw_duration_us(seq->dev, p->temp_c ? p->dur_ms : 0);
+
+    /* while it converts: the next profile goes into the other set-point */
+    seq->next = (idx + 1) % seq->count;
+    seq->slot ^= 1;
+    rc = load_profile(seq, seq->next, seq->slot);
+    if (rc) return rc;
+
+    uint32_t spent = elapsed_us(start);
+    if (spent < dur_us) {
+        k_usleep(dur_us - spent);
+    }
+
+    for (int tries = 0; (rc = bme680_raw_read(seq->dev, out)) == -EBUSY; tries++) {
+        if (tries == POLL_MAX) return -ETIMEDOUT;
+        k_usleep(POLL_US);
+    }
+    if (rc) return rc;
+
+    /* heater resistance targets track the ambient temperature */
+    seq->amb_c = out->temp / 100;
+
+    struct bme680_seq_stats *st = &seq->stats[idx];
+    st->count++;
+    st->busy_us += elapsed_us(start);
+    if (out->gas) st->gas_valid++;
+
+    if (profile) *profile = idx;
+    return 0;
+}
+
+void bme680_seq_print_stats(const struct bme680_seq *seq)
+{
+    for (size_t i = 0; i < seq->count; i++) {
+        const struct bme680_seq_stats *st = &seq->stats[i];
+        uint32_t rate_x100 = st->busy_us ? (uint32_t)((uint64_t)st->count * 100000000 / st->busy_us) : 0;
+
+        printk("profile %u (%u C, %u ms): %u meas, %u.%02u meas/s, %u gas valid\n",
+               (unsigned)i, seq->profiles[i].temp_c, seq->profiles[i].dur_ms, st->count,
+               rate_x100 / 100, rate_x100 % 100, st->gas_valid);
+    }
+}
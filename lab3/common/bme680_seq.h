@@ -0,0 +1,51 @@
+#ifndef BME680_SEQ_H
+#define BME680_SEQ_H
+
+/*
+ * Gas-heater profile sequencer for the raw BME680 path.
+ *
+ * Successive forced measurements cycle through a list of heater
+ * profiles. Two heater set-points are used in turn: while the sensor
+ * converts with one, the next profile is written to the other (with the
+ * latest ambient temperature), so configuration traffic overlaps the
+ * conversion wait instead of following it.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bme680_raw.h"
+
+#define BME680_SEQ_MAX_PROFILES 10
+
+struct bme680_heater_profile {
+    uint16_t temp_c;    // heater target, 0 = gas measurement off
+    uint16_t dur_ms;    // heating time before the gas reading
+};
+
+struct bme680_seq_stats {
+    uint32_t count;
+    uint32_t gas_valid;
+    uint64_t busy_us;   // trigger to result, summed
+};
+
+struct bme680_seq {
+    struct bme680_raw *dev;
+    const struct bme680_heater_profile *profiles;
+    size_t count;
+    size_t next;        // profile of the next measurement
+    uint8_t slot;       // heater set-point holding `next`
+    int32_t amb_c;
+    struct bme680_seq_stats stats[BME680_SEQ_MAX_PROFILES];
+};
+
+int bme680_seq_start(struct bme680_seq *seq, struct bme680_raw *dev,
+                     const struct bme680_heater_profile *profiles, size_t count);
+
+/* run one measurement with the next profile; *profile is its index */
+int bme680_seq_step(struct bme680_seq *seq, struct bme680_data *out, size_t *profile);
+
+/* measurements per second achieved for each profile */
+void bme680_seq_print_stats(const struct bme680_seq *seq);
+
+#endif /* BME680_SEQ_H */
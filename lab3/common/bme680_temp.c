@@ -0,0 +1,80 @@
+#include <zephyr/drivers/i2c.h>
+#include <errno.h>
+
+#include "bme680_comp.h"
+#include "bme680_temp.h"
+
+/* Temperature calibration registers (BME680) */
+#define DIG_T1_LSB 0xE9
+#define DIG_T2_LSB 0x8A
+#define DIG_T3     0x8C
+
+/* BME680 forced-mode, temp oversampling x1:
+   ctrl_meas: osrs_t[7:5]=001, mode[1:0]=01 -> (1<<5) | 0x01
+*/
+#define CTRL_MEAS_TEMP_X1_FORCED ((1u << 5) | 0x01)
+
+static inline int rd8(const struct bme680_temp *dev, uint8_t reg, uint8_t *val)
+{
+    return i2c_reg_read_byte(dev->i2c, dev->addr, reg, val);
+}
+
+static inline int rdN(const struct bme680_temp *dev, uint8_t start_reg, uint8_t *buf, size_t len)
+{
+    return i2c_burst_read(dev->i2c, dev->addr, start_reg, buf, len);
+}
+
+static inline int wr8(const struct bme680_temp *dev, uint8_t reg, uint8_t val)
+{
+    return i2c_reg_write_byte(dev->i2c, dev->addr, reg, val);
+}
+
+int bme680_temp_init(struct bme680_temp *dev, const struct device *i2c, uint16_t addr)
+{
+    uint8_t b[2];
+
+    dev->i2c = i2c;
+    dev->addr = addr;
+
+    /* Read temperature calibration parameters */
+    if (rdN(dev, DIG_T1_LSB, b, 2) != 0) return -EIO;
+    dev->T1 = (uint16_t)(b[0] | (b[1] << 8));
+
+    if (rdN(dev, DIG_T2_LSB, b, 2) != 0) return -EIO;
+    dev->T2 = (int16_t)(b[0] | (b[1] << 8));
+
+    if (rd8(dev, DIG_T3, (uint8_t *)&dev->T3) != 0) return -EIO;
+
+    /* Minimal config: humidity oversampling = 0 */
+    (void)wr8(dev, BME680_REG_CTRL_HUM, 0x00);
+    return 0;
+}
+
+int bme680_temp_trigger(const struct bme680_temp *dev)
+{
+    return wr8(dev, BME680_REG_CTRL_MEAS, CTRL_MEAS_TEMP_X1_FORCED);
+}
+
+int bme680_temp_read_adc(const struct bme680_temp *dev, int32_t *adc_T)
+{
+    /* Read raw temperature (20-bit) */
+    uint8_t t[3];
+    if (rdN(dev, BME680_REG_TEMP_MSB, t, 3) != 0) return -EIO;
+
+    /* t[0] : T[19:12]
+       t[1] : T[11:4]
+       t[2] : T[3:0]
+    */
+    *adc_T = ((int32_t)t[0] << 12) | ((int32_t)t[1] << 4) | ((int32_t)t[2] >> 4);
+    return 0;
+}
+
+int32_t bme680_temp_01C(const struct bme680_temp *dev, int32_t adc_T)
+{
+    /* the BME680 datasheet form: par_t3 scaled by 16, unlike the BME280's dig_T3 */
+    int32_t v1 = (adc_T >> 3) - ((int32_t)dev->T1 << 1);
+    int32_t v2 = (v1 * (int32_t)dev->T2) >> 11;
+    int32_t v3 = ((((v1 >> 1) * (v1 >> 1)) >> 12) * ((int32_t)dev->T3 << 4)) >> 14;
+    int32_t tf = v2 + v3;
+    return (tf * 5 + 128) >> 8;
+}
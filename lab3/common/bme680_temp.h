@@ -0,0 +1,37 @@
+#ifndef BME680_TEMP_H
+#define BME680_TEMP_H
+
+/*
+ * lab3/part1's BME680 code: temperature only at x1 oversampling, one
+ * forced measurement per sample read after a fixed wait, and the Bosch
+ * integer compensation over the three temperature calibration words.
+ * lab3/driver_bench runs the same functions against the Zephyr driver.
+ */
+
+#include <zephyr/device.h>
+#include <stdint.h>
+
+/* part1's wait between trigger and read */
+#define BME680_TEMP_WAIT_MS 200
+
+struct bme680_temp {
+    const struct device *i2c;
+    uint16_t addr;
+    uint16_t T1;
+    int16_t T2;
+    int8_t T3;
+};
+
+/* read the temperature calibration and switch humidity off */
+int bme680_temp_init(struct bme680_temp *dev, const struct device *i2c, uint16_t addr);
+
+/* start one forced temperature measurement */
+int bme680_temp_trigger(const struct bme680_temp *dev);
+
+/* the 20-bit temperature word of the last measurement */
+int bme680_temp_read_adc(const struct bme680_temp *dev, int32_t *adc_T);
+
+/* temperature in 0.01 C (Bosch compensation) */
+int32_t bme680_temp_01C(const struct bme680_temp *dev, int32_t adc_T);
+
+#endif /* BME680_TEMP_H */
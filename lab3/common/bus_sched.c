@@ -0,0 +1,193 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <errno.h>
+#include <string.h>
+
+#include "bus_sched.h"
+
+static int64_t now_us(void)
+{
+    return k_ticks_to_us_floor64(k_uptime_ticks());
+}
+
+static void sleep_until(int64_t t_us)
+{
+    k_sleep(K_TIMEOUT_ABS_TICKS(k_us_to_ticks_ceil64(t_us)));
+}
+
+/* one bus operation, timed into the device's and the bus's totals */
+static int bus_op(struct bus_sched *s, struct bus_sched_dev *d, int (*op)(struct bus_sched_dev *))
+{
+    uint32_t start = k_cycle_get_32();
+    int rc = op(d);
+    uint32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+    d->stats.bus_us += us;
+    s->bus_us += us;
+    return rc;
+}
+
+static void do_trigger(struct bus_sched *s, struct bus_sched_dev *d, int64_t now)
+{
+    struct bus_sched_dev_stats *st = &d->stats;
+    uint32_t late = (uint32_t)(now - d->release_us);
+
+    st->triggers++;
+    st->late_us += late;
+    if (late > st->max_late_us) st->max_late_us = late;
+
+    if (d->trigger_us >= 0) {
+        uint32_t interval = (uint32_t)(now - d->trigger_us);
+        if (interval < st->min_interval_us) st->min_interval_us = interval;
+        if (interval > st->max_interval_us) st->max_interval_us = interval;
+    }
+    d->trigger_us = now;
+    d->release_us += d->period_us;
+
+    if (bus_op(s, d, d->ops->trigger)) {
+        st->errors++;
+        return;
+    }
+    d->converting = true;
+    d->read_us = now + d->conversion_us;
+}
+
+static void do_read(struct bus_sched *s, struct bus_sched_dev *d, int64_t now)
+{
+    struct bus_sched_dev_stats *st = &d->stats;
+    int rc = bus_op(s, d, d->ops->read);
+
+    if (rc == -EBUSY) {
+        st->retries++;
+        d->read_us = now + CONFIG_APP_BUS_SCHED_POLL_US;
+        return;
+    }
+    d->converting = false;
+    if (rc) st->errors++;
+    else    st->samples++;
+
+    /* releases that passed entirely while this sample was in flight */
+    int64_t done = now_us();
+    while (d->release_us + d->period_us <= done) {
+        d->release_us += d->period_us;
+        st->overruns++;
+    }
+}
+
+/* is a (time t, trigger?) op of device a more urgent than b's? */
+static bool before(const struct bus_sched_dev *a, int64_t ta, const struct bus_sched_dev *b,
+                   int64_t tb, int64_t now)
+{
+    bool a_due = ta <= now, b_due = tb <= now;
+    bool a_trig = !a->converting, b_trig = !b->converting;
+
+    if (a_due != b_due) return a_due;
+    if (a_due && a_trig != b_trig) return a_trig;
+    if (ta != tb) return ta < tb;
+    if (a_trig != b_trig) return a_trig;
+    return a->period_us < b->period_us;
+}
+
+static struct bus_sched_dev *next_op(struct bus_sched *s, int64_t now, int64_t *t_us)
+{
+    struct bus_sched_dev *best = NULL;
+    int64_t best_t = 0;
+    bool busy = false;
+
+    /* serial: a converting device holds the bus until it is read */
+    if (s->serial) {
+        for (size_t i = 0; i < s->count; i++) {
+            busy |= s->devs[i].converting;
+        }
+    }
+
+    for (size_t i = 0; i < s->count; i++) {
+        struct bus_sched_dev *d = &s->devs[i];
+        if (busy && !d->converting) continue;
+
+        int64_t t = d->converting ? d->read_us : d->release_us;
+        if (!best || before(d, t, best, best_t, now)) {
+            best = d;
+            best_t = t;
+        }
+    }
+    *t_us = best_t;
+    return best;
+}
+
+void bus_sched_init(struct bus_sched *s, struct bus_sched_dev *devs, size_t count, bool serial)
+{
+    memset(s, 0, sizeof(*s));
+    s->devs = devs;
+    s->count = count;
+    s->serial = serial;
+    s->start_us = -1;
+
+    for (size_t i = 0; i < count; i++) {
+        struct bus_sched_dev *d = &devs[i];
+
+        d->converting = false;
+        d->trigger_us = -1;
+        memset(&d->stats, 0, sizeof(d->stats));
+        d->stats.min_interval_us = UINT32_MAX;
+    }
+}
+
+void bus_sched_run(struct bus_sched *s, uint32_t duration_ms)
+{
+    if (s->count == 0) return;
+
+    /* the first run releases every device at once */
+    if (s->start_us < 0) {
+        s->start_us = now_us();
+        for (size_t i = 0; i < s->count; i++) {
+            s->devs[i].release_us = s->start_us;
+        }
+    }
+
+    int64_t end = duration_ms ? now_us() + (int64_t)duration_ms * 1000 : INT64_MAX;
+
+    for (;;) {
+        int64_t now = now_us();
+        int64_t t;
+        struct bus_sched_dev *d = next_op(s, now, &t);
+
+        if (t >= end) {
+            sleep_until(end);
+            return;
+        }
+        if (t > now) {
+            sleep_until(t);
+            continue;
+        }
+
+        if (d->converting) do_read(s, d, now);
+        else               do_trigger(s, d, now);
+    }
+}
+
+void bus_sched_print_stats(const struct bus_sched *s)
+{
+    uint64_t elapsed = s->start_us < 0 ? 0 : (uint64_t)(now_us() - s->start_us);
+    uint32_t util_x100 = elapsed ? (uint32_t)(s->bus_us * 10000 / elapsed) : 0;
+
+    printk("bus (%s): %u ms, busy %u ms = %u.%02u%%\n", s->serial ? "serial" : "interleaved",
+           (uint32_t)(elapsed / 1000), (uint32_t)(s->bus_us / 1000), util_x100 / 100,
+           util_x100 % 100);
+
+    for (size_t i = 0; i < s->count; i++) {
+        const struct bus_sched_dev *d = &s->devs[i];
+        const struct bus_sched_dev_stats *st = &d->stats;
+        uint32_t rate_x100 = elapsed ? (uint32_t)((uint64_t)st->samples * 100000000 / elapsed) : 0;
+        uint32_t want_x100 = (uint32_t)(100000000ull / d->period_us);
+        bool intervals = st->max_interval_us != 0;
+
+        printk("  %-8s %5u ms %6u us: %3u.%02u/s of %3u.%02u, overruns %u, late avg %u max %u us, "
+               "interval %u..%u us (p-p %u), retries %u, errors %u\n",
+               d->name, d->period_us / 1000, d->conversion_us, rate_x100 / 100, rate_x100 % 100,
+               want_x100 / 100, want_x100 % 100, st->overruns,
+               st->triggers ? (uint32_t)(st->late_us / st->triggers) : 0, st->max_late_us,
+               intervals ? st->min_interval_us : 0, st->max_interval_us,
+               intervals ? st->max_interval_us - st->min_interval_us : 0, st->retries, st->errors);
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef BUS_SCHED_H
+#define BUS_SCHED_H
+
+/*
+ * Shared-bus scheduler for several forced-mode sensors.
+ *
+ * Each device has its own period and conversion time. A sample is two
+ * bus operations: trigger, and conversion_us later, read. One thread
+ * runs every operation in time order, so the bus serves the other
+ * devices while one converts instead of idling through its wait.
+ *
+ * Ordering: due triggers go first (they set the sampling instant and
+ * so the jitter), earliest release first, then shorter period; due
+ * reads follow, earliest first. A read that finds no result yet is
+ * retried CONFIG_APP_BUS_SCHED_POLL_US later. Releases that pass
+ * entirely while the device's previous sample is still in flight are
+ * skipped and counted as overruns; the last one it overlaps is
+ * triggered late, once the read is done.
+ *
+ * With `serial` set the scheduler instead waits out each conversion
+ * before touching the bus again, the way a plain trigger/sleep/read
+ * loop per device would; it is there for comparison.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct bus_sched_dev;
+
+struct bus_sched_ops {
+    /* start a conversion; 0 or a negative errno */
+    int (*trigger)(struct bus_sched_dev *dev);
+    /* fetch the result; 0, -EBUSY while converting, or a negative errno */
+    int (*read)(struct bus_sched_dev *dev);
+};
+
+struct bus_sched_dev_stats {
+    uint32_t triggers;
+    uint32_t samples;
+    uint32_t errors;
+    uint32_t retries;       // reads that found the conversion unfinished
+    uint32_t overruns;      // releases skipped, previous sample in flight
+    uint64_t late_us;       // trigger after its release, summed
+    uint32_t max_late_us;
+    uint32_t min_interval_us;   // trigger to trigger
+    uint32_t max_interval_us;
+    uint64_t bus_us;        // in this device's bus operations
+};
+
+struct bus_sched_dev {
+    const char *name;
+    const struct bus_sched_ops *ops;
+    void *ctx;
+    uint32_t period_us;
+    uint32_t conversion_us;
+
+    /* scheduler state */
+    bool converting;
+    int64_t release_us;     // ideal time of the next trigger
+    int64_t read_us;        // next read attempt while converting
+    int64_t trigger_us;     // last actual trigger
+    struct bus_sched_dev_stats stats;
+};
+
+struct bus_sched {
+    struct bus_sched_dev *devs;
+    size_t count;
+    bool serial;
+    int64_t start_us;
+    uint64_t bus_us;        // all bus operations, summed
+};
+
+void bus_sched_init(struct bus_sched *s, struct bus_sched_dev *devs, size_t count, bool serial);
+
+/* run the schedule in the calling thread for duration_ms (0 = forever) */
+void bus_sched_run(struct bus_sched *s, uint32_t duration_ms);
+
+/* bus utilization and per-device rate, lateness and interval jitter */
+void bus_sched_print_stats(const struct bus_sched *s);
+
+#endif /* BUS_SCHED_H */
@@ -0,0 +1,434 @@
+#include <zephyr/kernel.h>
+#include <zephyr/fs/fcb.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/printk.h>
+#include <errno.h>
+#include <string.h>
+
+#include "sample_log.h"
+
+#define LOG_PARTITION_ID FIXED_PARTITION_ID(storage_partition)
+#define LOG_MAGIC        0x53414d50   // "SAMP"
+#define BLOCK_SIZE       CONFIG_APP_SAMPLE_LOG_BLOCK_SIZE
+#define HDR_SIZE         sizeof(struct sample_log_block_hdr)
+#define VARINT_MAX       5
+
+BUILD_ASSERT(BLOCK_SIZE <= UINT16_MAX, "FCB entries are limited to 64 KiB");
+
+static struct fcb log_fcb;
+static struct flash_sector log_sectors[CONFIG_APP_SAMPLE_LOG_MAX_SECTORS];
+
+/* RAM index: time range of the blocks held in each sector */
+static struct {
+    uint32_t t0_ms;
+    uint32_t t1_ms;
+    bool valid;
+} sector_index[CONFIG_APP_SAMPLE_LOG_MAX_SECTORS];
+
+/* block being filled */
+static uint8_t blk[BLOCK_SIZE];
+static struct sample_log_block_hdr blk_hdr;
+static struct sample_log_sample blk_prev;
+
+static uint32_t time_base_ms;
+static uint32_t boot_ms;
+
+static struct sample_log_stats stats;
+static bool ready;
+
+K_MUTEX_DEFINE(log_lock);
+
+/* ===================== Encoding ===================== */
+static inline uint32_t zz_enc(int32_t v)
+{
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline int32_t zz_dec(uint32_t v)
+{
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+static size_t varint_put(uint8_t *out, uint32_t v)
+{
+    size_t n = 0;
+    do {
+        uint8_t b = v & 0x7f;
+        v >>= 7;
+        out[n++] = b | (v ? 0x80 : 0);
+    } while (v);
+    return n;
+}
+
+static size_t varint_get(const uint8_t *in, size_t len, uint32_t *v)
+{
+    uint32_t r = 0;
+    for (size_t n = 0; n < len && n < VARINT_MAX; n++) {
+        r |= (uint32_t)(in[n] & 0x7f) << (7 * n);
+        if (!(in[n] & 0x80)) {
+            *v = r;
+            return n + 1;
+        }
+    }
+    return 0;
+}
+
+/* decode a header + payload, passing samples inside [from, to] to cb */
+static int decode(const uint8_t *block, size_t len, uint32_t from, uint32_t to,
+                  sample_log_cb_t cb, void *arg)
+{
+    struct sample_log_block_hdr hdr;
+
+    if (len < HDR_SIZE) return -EINVAL;
+    memcpy(&hdr, block, HDR_SIZE);
+    if (HDR_SIZE + hdr.len > len) return -EINVAL;
+
+    const uint8_t *p = block + HDR_SIZE;
+    const uint8_t *end = p + hdr.len;
+    struct sample_log_sample s = { hdr.t0_ms, hdr.v0 };
+
+    for (uint16_t i = 0; i < hdr.count; i++) {
+        if (i > 0) {
+            uint32_t dt, dv;
+            size_t n = varint_get(p, end - p, &dt);
+            if (n == 0) return -EINVAL;
+            p += n;
+            n = varint_get(p, end - p, &dv);
+            if (n == 0) return -EINVAL;
+            p += n;
+
+            s.t_ms += dt;               // time never goes backwards, no zig-zag
+            s.value += zz_dec(dv);
+        }
+
+        if (s.t_ms > to) break;
+        if (s.t_ms >= from) {
+            int rc = cb(&s, arg);
+            if (rc) return rc;
+        }
+    }
+    return 0;
+}
+
+int sample_log_decode_block(const uint8_t *block, size_t len, sample_log_cb_t cb, void *arg)
+{
+    return decode(block, len, 0, UINT32_MAX, cb, arg);
+}
+
+/* ===================== Index ===================== */
+static inline int sector_id(const struct flash_sector *sector)
+{
+    return sector - log_sectors;
+}
+
+static void index_add(const struct flash_sector *sector, uint32_t t0, uint32_t t1)
+{
+    int id = sector_id(sector);
+
+    if (!sector_index[id].valid) {
+        sector_index[id].t0_ms = t0;
+        sector_index[id].valid = true;
+    }
+    sector_index[id].t1_ms = t1;
+}
+
+static int index_build_cb(struct fcb_entry_ctx *ctx, void *arg)
+{
+    ARG_UNUSED(arg);
+    struct sample_log_block_hdr hdr;
+
+    if (ctx->loc.fe_data_len < HDR_SIZE) return 0;
+    if (flash_area_read(ctx->fap, FCB_ENTRY_FA_DATA_OFF(ctx->loc), &hdr, HDR_SIZE) != 0) {
+        return 0;
+    }
+
+    index_add(ctx->loc.fe_sector, hdr.t0_ms, hdr.t1_ms);
+    if (hdr.t1_ms + 1 > time_base_ms) {
+        time_base_ms = hdr.t1_ms + 1;
+    }
+    return 0;
+}
+
+/* ===================== Flash ===================== */
+/* buf holds hdr followed by its payload */
+static int append_block(const struct sample_log_block_hdr *hdr, const uint8_t *buf, uint16_t len)
+{
+    struct fcb_entry loc;
+    struct flash_sector *before = log_fcb.f_active.fe_sector;
+
+    int rc = fcb_append(&log_fcb, len, &loc);
+    if (rc == -ENOSPC) {
+        /* log is full: drop the oldest sector and reuse it */
+        int oldest = sector_id(log_fcb.f_oldest);
+        rc = fcb_rotate(&log_fcb);
+        if (rc) return rc;
+        sector_index[oldest].valid = false;
+        stats.flash_erases++;
+
+        rc = fcb_append(&log_fcb, len, &loc);
+    }
+    if (rc) return rc;
+
+    /* moving to a new sector programs its FCB header */
+    if (loc.fe_sector != before) stats.flash_writes++;
+
+    rc = flash_area_write(log_fcb.fap, FCB_ENTRY_FA_DATA_OFF(loc), buf, len);
+    if (rc) return rc;
+
+    rc = fcb_append_finish(&log_fcb, &loc);
+    if (rc) return rc;
+
+    /* fcb_append() programs the entry length, fcb_append_finish() the crc */
+    stats.flash_writes += 3;
+    stats.blocks++;
+    stats.stored_bytes += len;
+
+    index_add(loc.fe_sector, hdr->t0_ms, hdr->t1_ms);
+    return 0;
+}
+
+static int flush_locked(void)
+{
+    if (blk_hdr.count == 0) return 0;
+
+    memcpy(blk, &blk_hdr, HDR_SIZE);
+    int rc = append_block(&blk_hdr, blk, HDR_SIZE + blk_hdr.len);
+    blk_hdr.count = 0;
+    return rc;
+}
+
+/* ===================== API ===================== */
+int sample_log_init(void)
+{
+    uint32_t cnt = ARRAY_SIZE(log_sectors);
+
+    int rc = flash_area_get_sectors(LOG_PARTITION_ID, &cnt, log_sectors);
+    if (rc) return rc;
+
+    log_fcb.f_magic = LOG_MAGIC;
+    log_fcb.f_version = 1;
+    log_fcb.f_sector_cnt = cnt;
+    log_fcb.f_scratch_cnt = 0;
+    log_fcb.f_sectors = log_sectors;
+
+    rc = fcb_init(LOG_PARTITION_ID, &log_fcb);
+    if (rc) return rc;
+
+    memset(sector_index, 0, sizeof(sector_index));
+    time_base_ms = 0;
+    rc = fcb_walk(&log_fcb, NULL, index_build_cb, NULL);
+    if (rc) return rc;
+
+    boot_ms = k_uptime_get_32();
+    ready = true;
+    return 0;
+}
+
+int sample_log_append(int32_t value)
+{
+    if (!ready) return -ENODEV;
+
+    k_mutex_lock(&log_lock, K_FOREVER);
+
+    uint32_t t = time_base_ms + (k_uptime_get_32() - boot_ms);
+    int rc = 0;
+
+    stats.samples++;
+    stats.raw_bytes += sizeof(struct sample_log_sample);
+
+    bool appended = false;
+    if (blk_hdr.count > 0) {
+        uint8_t enc[2 * VARINT_MAX];
+        size_t n = varint_put(enc, t - blk_prev.t_ms);
+        n += varint_put(enc + n, zz_enc(value - blk_prev.value));
+
+        if (HDR_SIZE + blk_hdr.len + n <= BLOCK_SIZE && blk_hdr.count < UINT16_MAX) {
+            memcpy(blk + HDR_SIZE + blk_hdr.len, enc, n);
+            blk_hdr.len += n;
+            blk_hdr.count++;
+            blk_hdr.t1_ms = t;
+            appended = true;
+        } else {
+            rc = flush_locked();
+        }
+    }
+
+    if (!appended) {
+        /* first sample of a block is kept in the header */
+        blk_hdr.t0_ms = t;
+        blk_hdr.t1_ms = t;
+        blk_hdr.v0 = value;
+        blk_hdr.count = 1;
+        blk_hdr.len = 0;
+    }
+
+    blk_prev.t_ms = t;
+    blk_prev.value = value;
+    k_mutex_unlock(&log_lock);
+    return rc;
+}
+
+int sample_log_flush(void)
+{
+    if (!ready) return -ENODEV;
+
+    k_mutex_lock(&log_lock, K_FOREVER);
+    int rc = flush_locked();
+    k_mutex_unlock(&log_lock);
+    return rc;
+}
+
+int sample_log_flush_older(uint32_t max_age_ms)
+{
+    if (!ready) return -ENODEV;
+
+    k_mutex_lock(&log_lock, K_FOREVER);
+
+    uint32_t t = time_base_ms + (k_uptime_get_32() - boot_ms);
+    int rc = 0;
+
+    if (blk_hdr.count > 0 && t - blk_hdr.t0_ms >= max_age_ms) {
+        rc = flush_locked();
+    }
+    k_mutex_unlock(&log_lock);
+    return rc;
+}
+
+struct read_ctx {
+    uint32_t from;
+    uint32_t to;
+    sample_log_cb_t cb;
+    void *arg;
+    int rc;
+    bool done;
+    uint8_t buf[BLOCK_SIZE];
+};
+
+static int read_block_cb(struct fcb_entry_ctx *ec, void *arg)
+{
+    struct read_ctx *ctx = arg;
+    uint16_t len = ec->loc.fe_data_len;
+    struct sample_log_block_hdr hdr;
+
+    if (len < HDR_SIZE || len > BLOCK_SIZE) return 0;
+
+    /* the header alone decides whether the payload is needed */
+    if (flash_area_read(ec->fap, FCB_ENTRY_FA_DATA_OFF(ec->loc), &hdr, HDR_SIZE) != 0) {
+        ctx->rc = -EIO;
+        return 1;
+    }
+    if (hdr.t0_ms > ctx->to) {
+        ctx->done = true;
+        return 1;
+    }
+    if (hdr.t1_ms < ctx->from) return 0;
+
+    if (flash_area_read(ec->fap, FCB_ENTRY_FA_DATA_OFF(ec->loc), ctx->buf, len) != 0) {
+        ctx->rc = -EIO;
+        return 1;
+    }
+
+    ctx->rc = decode(ctx->buf, len, ctx->from, ctx->to, ctx->cb, ctx->arg);
+    return ctx->rc != 0;
+}
+
+int sample_log_read(uint32_t from_ms, uint32_t to_ms, sample_log_cb_t cb, void *arg)
+{
+    static struct read_ctx ctx;
+
+    if (!ready) return -ENODEV;
+
+    k_mutex_lock(&log_lock, K_FOREVER);
+
+    ctx = (struct read_ctx){ .from = from_ms, .to = to_ms, .cb = cb, .arg = arg };
+
+    /* sectors in age order, skipping those outside the range */
+    int id = sector_id(log_fcb.f_oldest);
+    int active = sector_id(log_fcb.f_active.fe_sector);
+
+    for (uint32_t n = 0; n < log_fcb.f_sector_cnt && !ctx.done && ctx.rc == 0; n++) {
+        if (sector_index[id].valid &&
+            sector_index[id].t1_ms >= from_ms && sector_index[id].t0_ms <= to_ms) {
+            fcb_walk(&log_fcb, &log_sectors[id], read_block_cb, &ctx);
+        }
+        if (id == active) break;
+        id = (id + 1) % log_fcb.f_sector_cnt;
+    }
+
+    /* samples not yet flushed */
+    if (!ctx.done && ctx.rc == 0 && blk_hdr.count > 0) {
+        memcpy(blk, &blk_hdr, HDR_SIZE);
+        ctx.rc = decode(blk, HDR_SIZE + blk_hdr.len, from_ms, to_ms, cb, arg);
+    }
+
+    int rc = ctx.rc;
+    k_mutex_unlock(&log_lock);
+    return rc < 0 ? rc : 0;
+}
+
+struct export_ctx {
+    sample_log_block_cb_t cb;
+    void *arg;
+    int rc;
+    uint8_t buf[BLOCK_SIZE];
+};
+
+static int export_block_cb(struct fcb_entry_ctx *ec, void *arg)
+{
+    struct export_ctx *ctx = arg;
+    uint16_t len = ec->loc.fe_data_len;
+
+    if (len < HDR_SIZE || len > BLOCK_SIZE) return 0;
+
+    if (flash_area_read(ec->fap, FCB_ENTRY_FA_DATA_OFF(ec->loc), ctx->buf, len) != 0) {
+        ctx->rc = -EIO;
+        return 1;
+    }
+    ctx->rc = ctx->cb(ctx->buf, len, ctx->arg);
+    return ctx->rc != 0;
+}
+
+int sample_log_export(sample_log_block_cb_t cb, void *arg)
+{
+    static struct export_ctx ctx;
+
+    if (!ready) return -ENODEV;
+
+    k_mutex_lock(&log_lock, K_FOREVER);
+    ctx = (struct export_ctx){ .cb = cb, .arg = arg };
+    int rc = fcb_walk(&log_fcb, NULL, export_block_cb, &ctx);
+    if (rc == 0) rc = ctx.rc;
+    k_mutex_unlock(&log_lock);
+    return rc < 0 ? rc : 0;
+}
+
+void sample_log_get_stats(struct sample_log_stats *out)
+{
+    k_mutex_lock(&log_lock, K_FOREVER);
+    *out = stats;
+    k_mutex_unlock(&log_lock);
+}
+
+void sample_log_print_stats(void)
+{
+    k_mutex_lock(&log_lock, K_FOREVER);
+    struct sample_log_stats s = stats;
+    uint32_t pending = blk_hdr.count;
+    k_mutex_unlock(&log_lock);
+
+    if (s.stored_bytes == 0) {
+        printk("sample_log: %u samples, nothing flushed yet\n", s.samples);
+        return;
+    }
+
+    /* only flushed samples count towards the ratio */
+    uint32_t flushed = s.samples - pending;
+    uint32_t raw = flushed * sizeof(struct sample_log_sample);
+    uint32_t ratio_x100 = (uint32_t)((uint64_t)raw * 100 / s.stored_bytes);
+    uint32_t writes_per_1k = (uint32_t)((uint64_t)s.flash_writes * 1000 / flushed);
+
+    printk("sample_log: %u samples in %u blocks, ratio %u.%02u:1, "
+           "%u flash writes/1000 samples, %u erases\n",
+           s.samples, s.blocks, ratio_x100 / 100, ratio_x100 % 100,
+           writes_per_1k, s.flash_erases);
+}
@@ -0,0 +1,77 @@
+#ifndef SAMPLE_LOG_H
+#define SAMPLE_LOG_H
+
+/*
+ * Flash-backed compressed sample log.
+ *
+ * Samples are delta + zig-zag varint encoded into blocks of
+ * CONFIG_APP_SAMPLE_LOG_BLOCK_SIZE bytes. A full block is appended to a
+ * flash circular buffer (FCB) on storage_partition; the FCB rotates
+ * through all sectors, erasing the oldest one only when the log wraps,
+ * which spreads wear evenly.
+ *
+ * Every block starts with a small header holding its time range, and a
+ * per-sector index of those ranges is kept in RAM, so a time-range read
+ * only touches and decodes the blocks that overlap it.
+ *
+ * Timestamps are "log time" in ms: continuous across reboots (the
+ * newest stored timestamp is the origin for the next boot).
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct sample_log_sample {
+    uint32_t t_ms;
+    int32_t  value;     // temperature in 0.01 C
+};
+
+/* On-flash block header, followed by the varint payload */
+struct sample_log_block_hdr {
+    uint32_t t0_ms;     // first sample, stored verbatim
+    uint32_t t1_ms;     // last sample
+    int32_t  v0;
+    uint16_t count;
+    uint16_t len;       // payload bytes
+};
+
+struct sample_log_stats {
+    uint32_t samples;
+    uint32_t blocks;
+    uint32_t raw_bytes;     // samples * sizeof(struct sample_log_sample)
+    uint32_t stored_bytes;  // headers + payload written to flash
+    uint32_t flash_writes;  // program operations (FCB length + data + FCB crc)
+    uint32_t flash_erases;
+};
+
+/* per-sample callback; return non-zero to stop the read */
+typedef int (*sample_log_cb_t)(const struct sample_log_sample *s, void *arg);
+
+/* per-block callback for bulk export: raw header + payload bytes */
+typedef int (*sample_log_block_cb_t)(const uint8_t *block, size_t len, void *arg);
+
+/* mount the FCB and rebuild the RAM index */
+int sample_log_init(void);
+
+/* append one sample stamped with the current log time */
+int sample_log_append(int32_t value);
+
+/* write the partially filled RAM block to flash */
+int sample_log_flush(void);
+
+/* sample_log_flush() once the block's oldest sample is max_age_ms old */
+int sample_log_flush_older(uint32_t max_age_ms);
+
+/* decode every stored sample with from_ms <= t <= to_ms, oldest first */
+int sample_log_read(uint32_t from_ms, uint32_t to_ms, sample_log_cb_t cb, void *arg);
+
+/* stream all stored blocks, still encoded, oldest first */
+int sample_log_export(sample_log_block_cb_t cb, void *arg);
+
+/* decode one exported block */
+int sample_log_decode_block(const uint8_t *block, size_t len, sample_log_cb_t cb, void *arg);
+
+void sample_log_get_stats(struct sample_log_stats *out);
+void sample_log_print_stats(void);
+
+#endif /* SAMPLE_LOG_H */
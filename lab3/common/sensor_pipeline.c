@@ -0,0 +1,232 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/printk.h>
+#include <errno.h>
+#include <string.h>
+
+#include "app_stats.h"
+#include "sensor_pipeline.h"
+
+#define STACK_SIZE 1024
+#define PRIO_ACQ   4
+#define PRIO_PROC  5
+#define PRIO_OUT   7    // the console gets whatever time is left
+
+K_MEM_SLAB_DEFINE_STATIC(pool, sizeof(struct pipeline_sample), CONFIG_APP_PIPELINE_POOL_SIZE, 4);
+K_FIFO_DEFINE(proc_fifo);
+K_FIFO_DEFINE(out_fifo);
+
+static const struct pipeline_ops *ops;
+static atomic_t interval_ms;
+static atomic_t depth[PIPELINE_STAGES];
+
+static struct k_spinlock lock;
+static struct pipeline_stats stats;
+static int64_t stats_since_ms;
+
+static const char *const stage_name[PIPELINE_STAGES] = { "acq", "proc", "out" };
+
+/* the same numbers for "stats show pipeline" (CONFIG_APP_STATS) */
+APP_STAT_COUNTER_DEFINE(st_pipe_acq_drops, "pipeline.acq_drops");
+APP_STAT_COUNTER_DEFINE(st_pipe_out_drops, "pipeline.out_drops");
+APP_STAT_MAX_DEFINE(st_pipe_proc_depth, "pipeline.proc_depth", "samples");
+APP_STAT_MAX_DEFINE(st_pipe_out_depth, "pipeline.out_depth", "samples");
+APP_STAT_HIST_DEFINE(st_pipe_e2e, "pipeline.e2e", "us");
+
+/* ===================== Counters ===================== */
+static void record(enum pipeline_stage st, uint32_t wait_us, uint32_t run_cyc)
+{
+    uint32_t run_us = k_cyc_to_us_floor32(run_cyc);
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    struct pipeline_stage_stats *s = &stats.stage[st];
+
+    s->count++;
+    s->wait_us += wait_us;
+    s->run_us += run_us;
+    if (wait_us > s->max_wait_us) s->max_wait_us = wait_us;
+    if (run_us > s->max_run_us) s->max_run_us = run_us;
+    k_spin_unlock(&lock, key);
+}
+
+static void record_drop(enum pipeline_stage st)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    stats.stage[st].dropped++;
+    k_spin_unlock(&lock, key);
+
+    app_stat_inc(st == PIPELINE_ACQ ? &st_pipe_acq_drops : &st_pipe_out_drops);
+}
+
+static void enqueue(struct k_fifo *fifo, enum pipeline_stage st, struct pipeline_sample *s)
+{
+    uint32_t d = (uint32_t)atomic_inc(&depth[st]) + 1;
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    if (d > stats.stage[st].max_depth) stats.stage[st].max_depth = d;
+    k_spin_unlock(&lock, key);
+
+    app_stat_max(st == PIPELINE_PROC ? &st_pipe_proc_depth : &st_pipe_out_depth, d);
+
+    s->t_enq = k_cycle_get_32();
+    k_fifo_put(fifo, s);
+}
+
+static struct pipeline_sample *dequeue(struct k_fifo *fifo, enum pipeline_stage st)
+{
+    struct pipeline_sample *s = k_fifo_get(fifo, K_FOREVER);
+
+    atomic_dec(&depth[st]);
+    return s;
+}
+
+/* ===================== Stages ===================== */
+static void acq_task(void *p1, void *p2, void *p3)
+{
+    uint32_t seq = 0;
+    int64_t next = k_uptime_ticks();
+
+    while (1) {
+        /* how late the period started: the acquisition stage's "wait" */
+        uint32_t late_us = (uint32_t)k_ticks_to_us_floor64(k_uptime_ticks() - next);
+        struct pipeline_sample *s;
+
+        if (k_mem_slab_alloc(&pool, (void **)&s, K_NO_WAIT) != 0) {
+            record_drop(PIPELINE_ACQ);
+        } else {
+            uint32_t t0 = k_cycle_get_32();
+
+            if (ops->acquire(s) == 0) {
+                s->seq = seq++;
+                s->t_acq = k_cycle_get_32();
+                record(PIPELINE_ACQ, late_us, s->t_acq - t0);
+                enqueue(&proc_fifo, PIPELINE_PROC, s);
+            } else {
+                k_mem_slab_free(&pool, s);
+                record_drop(PIPELINE_ACQ);
+            }
+        }
+
+        /* fixed-rate schedule; a late period is not made up */
+        int64_t now = k_uptime_ticks();
+        next += k_ms_to_ticks_ceil64((uint32_t)atomic_get(&interval_ms));
+        if (next < now) next = now;
+        k_sleep(K_TIMEOUT_ABS_TICKS(next));
+    }
+}
+
+static void proc_task(void *p1, void *p2, void *p3)
+{
+    while (1) {
+        struct pipeline_sample *s = dequeue(&proc_fifo, PIPELINE_PROC);
+        uint32_t t0 = k_cycle_get_32();
+        uint32_t next_ms = ops->process(s);
+
+        if (next_ms) atomic_set(&interval_ms, (atomic_val_t)next_ms);
+        record(PIPELINE_PROC, k_cyc_to_us_floor32(t0 - s->t_enq), k_cycle_get_32() - t0);
+
+        /* backpressure point: a slow console loses lines, nothing else */
+        if (atomic_get(&depth[PIPELINE_OUT]) >= CONFIG_APP_PIPELINE_OUT_DEPTH) {
+            k_mem_slab_free(&pool, s);
+            record_drop(PIPELINE_OUT);
+            continue;
+        }
+        enqueue(&out_fifo, PIPELINE_OUT, s);
+    }
+}
+
+static void out_task(void *p1, void *p2, void *p3)
+{
+    while (1) {
+        struct pipeline_sample *s = dequeue(&out_fifo, PIPELINE_OUT);
+        uint32_t t0 = k_cycle_get_32();
+
+        ops->output(s);
+
+        uint32_t t1 = k_cycle_get_32();
+        uint32_t e2e_us = k_cyc_to_us_floor32(t1 - s->t_acq);
+
+        record(PIPELINE_OUT, k_cyc_to_us_floor32(t0 - s->t_enq), t1 - t0);
+
+        k_spinlock_key_t key = k_spin_lock(&lock);
+        stats.e2e_us += e2e_us;
+        if (e2e_us > stats.max_e2e_us) stats.max_e2e_us = e2e_us;
+        k_spin_unlock(&lock, key);
+        app_stat_hist_record(&st_pipe_e2e, e2e_us);
+
+        k_mem_slab_free(&pool, s);
+    }
+}
+
+/* created stopped; pipeline_start() releases them */
+K_THREAD_DEFINE(pipe_acq_tid,  STACK_SIZE, acq_task,  NULL, NULL, NULL, PRIO_ACQ,  0, SYS_FOREVER_MS);
+K_THREAD_DEFINE(pipe_proc_tid, STACK_SIZE, proc_task, NULL, NULL, NULL, PRIO_PROC, 0, SYS_FOREVER_MS);
+K_THREAD_DEFINE(pipe_out_tid,  STACK_SIZE, out_task,  NULL, NULL, NULL, PRIO_OUT,  0, SYS_FOREVER_MS);
+
+/* ===================== API ===================== */
+int pipeline_start(const struct pipeline_ops *pipeline_ops, uint32_t interval)
+{
+    if (ops) return -EALREADY;
+    if (!pipeline_ops->acquire || !pipeline_ops->process || !pipeline_ops->output) {
+        return -EINVAL;
+    }
+
+    ops = pipeline_ops;
+    atomic_set(&interval_ms, (atomic_val_t)interval);
+    stats_since_ms = k_uptime_get();
+
+    k_thread_start(pipe_out_tid);
+    k_thread_start(pipe_proc_tid);
+    k_thread_start(pipe_acq_tid);
+    return 0;
+}
+
+void pipeline_get_stats(struct pipeline_stats *out)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    *out = stats;
+    out->elapsed_ms = (uint32_t)(k_uptime_get() - stats_since_ms);
+    k_spin_unlock(&lock, key);
+
+    for (int i = 0; i < PIPELINE_STAGES; i++) {
+        out->stage[i].depth = (uint32_t)atomic_get(&depth[i]);
+    }
+}
+
+void pipeline_reset_stats(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    memset(&stats, 0, sizeof(stats));
+    stats_since_ms = k_uptime_get();
+    k_spin_unlock(&lock, key);
+}
+
+static uint32_t avg(uint64_t sum, uint32_t n)
+{
+    return n ? (uint32_t)(sum / n) : 0;
+}
+
+void pipeline_print_stats(void)
+{
+    struct pipeline_stats st;
+
+    pipeline_get_stats(&st);
+
+    uint32_t ms = st.elapsed_ms ? st.elapsed_ms : 1;
+    uint32_t acq_x100 = (uint32_t)((uint64_t)st.stage[PIPELINE_ACQ].count * 100000 / ms);
+    uint32_t out_x100 = (uint32_t)((uint64_t)st.stage[PIPELINE_OUT].count * 100000 / ms);
+
+    printk("pipeline: %u ms, acquired %u.%02u/s, output %u.%02u/s, e2e avg %u us max %u us\n",
+           st.elapsed_ms, acq_x100 / 100, acq_x100 % 100, out_x100 / 100, out_x100 % 100,
+           avg(st.e2e_us, st.stage[PIPELINE_OUT].count), st.max_e2e_us);
+
+    for (int i = 0; i < PIPELINE_STAGES; i++) {
+        const struct pipeline_stage_stats *s = &st.stage[i];
+
+        printk("  %-4s n %u drop %u depth %u/%u wait avg %u max %u us, run avg %u max %u us\n",
+               stage_name[i], s->count, s->dropped, s->depth, s->max_depth,
+               avg(s->wait_us, s->count), s->max_wait_us,
+               avg(s->run_us, s->count), s->max_run_us);
+    }
+}
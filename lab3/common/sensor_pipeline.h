@@ -0,0 +1,74 @@
+#ifndef SENSOR_PIPELINE_H
+#define SENSOR_PIPELINE_H
+
+/*
+ * Staged sensor pipeline: acquisition, processing and output run in
+ * their own threads, so a slow console no longer holds up the I2C
+ * reads.
+ *
+ * Samples live in a fixed slab of CONFIG_APP_PIPELINE_POOL_SIZE buffers
+ * and move between stages by pointer (k_fifo); the payload is filled by
+ * acquire() and converted in place by process(), never copied.
+ *
+ * Backpressure: acquisition never blocks. Only the output stage may fall
+ * behind; once CONFIG_APP_PIPELINE_OUT_DEPTH samples wait for it, the
+ * processing stage drops the newest one after processing it, so the
+ * sample log and the rate controller still see every sample and only
+ * console lines are lost. Should the pool still run dry, acquisition
+ * skips that period and counts a drop.
+ */
+
+#include <zephyr/toolchain.h>
+#include <stdint.h>
+
+enum pipeline_stage {
+    PIPELINE_ACQ,
+    PIPELINE_PROC,
+    PIPELINE_OUT,
+    PIPELINE_STAGES,
+};
+
+struct pipeline_sample {
+    void *fifo_reserved;    // k_fifo link
+    uint32_t seq;
+    uint32_t t_acq;         // cycle count when acquire() returned
+    uint32_t t_enq;         // cycle count when queued for the current stage
+    uint8_t payload[CONFIG_APP_PIPELINE_PAYLOAD_SIZE] __aligned(4);
+};
+
+struct pipeline_ops {
+    /* acquisition thread: fill s->payload from the bus; nonzero = no sample */
+    int (*acquire)(struct pipeline_sample *s);
+    /* processing thread: convert the payload in place; returns the next
+       acquisition interval in ms */
+    uint32_t (*process)(struct pipeline_sample *s);
+    /* output thread: format and print */
+    void (*output)(const struct pipeline_sample *s);
+};
+
+struct pipeline_stage_stats {
+    uint32_t count;         // samples the stage completed
+    uint32_t dropped;       // samples dropped at this stage
+    uint32_t depth;         // queue in front of the stage, now
+    uint32_t max_depth;
+    uint64_t wait_us;       // time spent queued, summed
+    uint32_t max_wait_us;
+    uint64_t run_us;        // time in the stage callback, summed
+    uint32_t max_run_us;
+};
+
+struct pipeline_stats {
+    struct pipeline_stage_stats stage[PIPELINE_STAGES];
+    uint64_t e2e_us;        // acquisition to output done, summed
+    uint32_t max_e2e_us;
+    uint32_t elapsed_ms;    // since start or the last reset
+};
+
+/* start the three threads; interval_ms until process() returns one */
+int pipeline_start(const struct pipeline_ops *ops, uint32_t interval_ms);
+
+void pipeline_get_stats(struct pipeline_stats *out);
+void pipeline_reset_stats(void);
+void pipeline_print_stats(void);
+
+#endif /* SENSOR_PIPELINE_H */
@@ -0,0 +1,233 @@
+/*
+ * lab3/part1's raw-register BME680 code vs the Zephyr sensor driver
+ * (lab3/part2's path), side by side.
+ *
+ * Both paths measure the same sensor node (emulated on native_sim, real
+ * on the board), each the way its lab3 app does: part1 through
+ * lab3/common/bme680_temp.c (T x1, forced, BME680_TEMP_WAIT_MS, its own
+ * compensation), the driver with sensor_sample_fetch() at its defaults
+ * (T x2, P x16, H x1, heater 320 C for 150 ms) and the temperature
+ * channel. Samples alternate between the paths so both see the same
+ * environment. Per path:
+ *   - I2C bytes, messages and transfers per sample (CONFIG_I2C_STATS)
+ *   - CPU cycles per sample: the thread's own run time, so the
+ *     conversion wait does not count (CONFIG_THREAD_RUNTIME_STATS)
+ *   - end-to-end latency, trigger to compensated result
+ * and a differential check that the two temperatures agree within
+ * CONFIG_BENCH_TOLERANCE. On the emulator each path is also checked
+ * against the temperature the model was given.
+ *
+ * Footprint: the build prints the size of each path's code and data
+ * after the link (see CMakeLists.txt).
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/sys/printk.h>
+#include <stdlib.h>
+
+#ifdef CONFIG_BENCH_RAW
+#include "bme680_temp.h"
+#endif
+
+#ifdef CONFIG_EMUL
+#include "bme680_model.h"
+#endif
+
+#define BME_NODE DT_NODELABEL(bme680)
+
+struct reading {
+    int32_t  temp;      // 0.01 C
+};
+
+struct path_result {
+    const char *name;
+    uint32_t n;
+    uint32_t errors;
+    uint64_t bytes, msgs, xfers;
+    uint64_t cpu_cyc;
+    uint64_t lat_us;
+    uint32_t max_lat_us;
+};
+
+struct snapshot {
+    uint32_t bytes, msgs, xfers;
+    uint64_t cpu_cyc;
+    uint32_t cyc;
+};
+
+static const struct device *const bus = DEVICE_DT_GET(DT_BUS(BME_NODE));
+
+static void snapshot(struct snapshot *s)
+{
+    *s = (struct snapshot){ 0 };
+#ifdef CONFIG_I2C_STATS
+    const struct i2c_device_state *st =
+        CONTAINER_OF(bus->state, struct i2c_device_state, devstate);
+
+    s->bytes = st->stats.bytes_read + st->stats.bytes_written;
+    s->msgs = st->stats.message_count;
+    s->xfers = st->stats.transfer_call_count;
+#endif
+    k_thread_runtime_stats_t rt;
+
+    k_thread_runtime_stats_get(k_current_get(), &rt);
+    s->cpu_cyc = rt.execution_cycles;
+    s->cyc = k_cycle_get_32();
+}
+
+static void account(struct path_result *r, const struct snapshot *a, const struct snapshot *b)
+{
+    uint32_t lat_us = k_cyc_to_us_floor32(b->cyc - a->cyc);
+
+    r->n++;
+    r->bytes += b->bytes - a->bytes;
+    r->msgs += b->msgs - a->msgs;
+    r->xfers += b->xfers - a->xfers;
+    r->cpu_cyc += b->cpu_cyc - a->cpu_cyc;
+    r->lat_us += lat_us;
+    if (lat_us > r->max_lat_us) r->max_lat_us = lat_us;
+}
+
+/* ===================== Raw-register path (lab3/part1) ===================== */
+#ifdef CONFIG_BENCH_RAW
+static struct bme680_temp raw;
+
+static int raw_init(void)
+{
+    return bme680_temp_init(&raw, bus, DT_REG_ADDR(BME_NODE));
+}
+
+/* part1's sample_read() and sample_process() */
+static int raw_sample(struct reading *out)
+{
+    int32_t adc_T;
+    int rc = bme680_temp_trigger(&raw);
+
+    if (rc) return rc;
+    k_msleep(BME680_TEMP_WAIT_MS);
+    rc = bme680_temp_read_adc(&raw, &adc_T);
+    if (rc) return rc;
+
+    out->temp = bme680_temp_01C(&raw, adc_T);
+    return 0;
+}
+#endif
+
+/* ===================== Sensor-driver path ===================== */
+#ifdef CONFIG_BENCH_DRIVER
+static const struct device *const drv = DEVICE_DT_GET(BME_NODE);
+
+/* part2's read: fetch everything, use the temperature */
+static int drv_sample(struct reading *out)
+{
+    struct sensor_value t;
+
+    if (sensor_sample_fetch(drv) < 0) return -EIO;
+    if (sensor_channel_get(drv, SENSOR_CHAN_AMBIENT_TEMP, &t) < 0) return -EIO;
+
+    /* C in sensor_value (integer + 1e-6 parts) */
+    out->temp = t.val1 * 100 + t.val2 / 10000;
+    return 0;
+}
+#endif
+
+/* ===================== Report ===================== */
+static void report(const struct path_result *r)
+{
+    if (!r->n) {
+        printk("%-7s no samples (%u errors)\n", r->name, r->errors);
+        return;
+    }
+
+    uint64_t cpu_cyc = r->cpu_cyc / r->n;
+
+    printk("%-7s %5u %7u %6u %6u %6u %10u %7u %9u %9u\n", r->name, r->n, r->errors,
+           (uint32_t)(r->xfers / r->n), (uint32_t)(r->msgs / r->n), (uint32_t)(r->bytes / r->n),
+           (uint32_t)cpu_cyc, (uint32_t)k_cyc_to_us_floor64(cpu_cyc),
+           (uint32_t)(r->lat_us / r->n), r->max_lat_us);
+}
+
+int main(void)
+{
+    static struct path_result res_raw = { .name = "raw" }, res_drv = { .name = "driver" };
+    int32_t max_dt = 0;
+    uint32_t compared = 0;
+#ifdef CONFIG_EMUL
+    int32_t max_err_a = 0, max_err_b = 0;
+#endif
+
+    if (!device_is_ready(bus)) {
+        printk("%s not ready\n", bus->name);
+        return -1;
+    }
+
+#ifdef CONFIG_BENCH_RAW
+    if (raw_init() != 0) {
+        printk("raw path: bme680 setup failed\n");
+        return -1;
+    }
+#endif
+#ifdef CONFIG_BENCH_DRIVER
+    if (!device_is_ready(drv)) {
+        printk("driver path: BME680 device not ready\n");
+        return -1;
+    }
+#endif
+
+    for (int i = 0; i < CONFIG_BENCH_SAMPLES; i++) {
+        struct reading a = { 0 }, b = { 0 };
+        struct snapshot s0, s1;
+        bool have_a = false, have_b = false;
+
+        ARG_UNUSED(a);
+        ARG_UNUSED(b);
+
+#ifdef CONFIG_BENCH_RAW
+        snapshot(&s0);
+        have_a = raw_sample(&a) == 0;
+        snapshot(&s1);
+        if (have_a) account(&res_raw, &s0, &s1);
+        else res_raw.errors++;
+#endif
+#ifdef CONFIG_BENCH_DRIVER
+        snapshot(&s0);
+        have_b = drv_sample(&b) == 0;
+        snapshot(&s1);
+        if (have_b) account(&res_drv, &s0, &s1);
+        else res_drv.errors++;
+#endif
+
+#ifdef CONFIG_EMUL
+        /* the emulator's ADC words come from the datasheet's float formulas */
+        if (have_a) max_err_a = MAX(max_err_a, abs(a.temp - BME680_MODEL_TEMP));
+        if (have_b) max_err_b = MAX(max_err_b, abs(b.temp - BME680_MODEL_TEMP));
+#endif
+
+        /* differential check on back-to-back samples */
+        if (have_a && have_b) {
+            max_dt = MAX(max_dt, abs(a.temp - b.temp));
+            compared++;
+        }
+    }
+
+    printk("\n%-7s %5s %7s %6s %6s %6s %10s %7s %9s %9s\n", "path", "n", "errors", "xfers",
+           "msgs", "bytes", "cpu cyc", "cpu us", "lat us", "max us");
+    report(&res_raw);
+    report(&res_drv);
+
+    if (compared) {
+        printk("\ndifferential (%u pairs): max |dT| %d.%02d C: %s\n", compared, max_dt / 100,
+               max_dt % 100, max_dt <= CONFIG_BENCH_TOLERANCE ? "PASS" : "FAIL");
+    }
+#ifdef CONFIG_EMUL
+    printk("vs model %d.%02d C: raw max |dT| %d.%02d C: %s, driver max |dT| %d.%02d C: %s\n",
+           BME680_MODEL_TEMP / 100, BME680_MODEL_TEMP % 100,
+           max_err_a / 100, max_err_a % 100, max_err_a <= CONFIG_BENCH_TOLERANCE ? "PASS" : "FAIL",
+           max_err_b / 100, max_err_b % 100, max_err_b <= CONFIG_BENCH_TOLERANCE ? "PASS" : "FAIL");
+#endif
+    return 0;
+}
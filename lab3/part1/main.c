@@ -4,87 +4,261 @@
 #include <zephyr/drivers/i2c.h>
 #include <zephyr/sys/printk.h>
 
-#include "bme680_reg.h"
+#include "bme680_comp.h"
+#include "bme680_temp.h"
+
+#include "app_stats.h"
+
+#ifdef CONFIG_APP_SAMPLE_LOG
+#include "sample_log.h"
+#endif
+
+#ifdef CONFIG_APP_ADAPTIVE_RATE
+#include "adaptive_rate.h"
+#endif
+
+#ifdef CONFIG_APP_BME680_SEQ
+#include "bme680_raw.h"
+#include "bme680_seq.h"
+#endif
+
+#ifdef CONFIG_APP_PIPELINE
+#include "sensor_pipeline.h"
+#endif
 
 #define I2C_NODE DT_NODELABEL(i2c0)
 #define BME680_ADDR 0x77
 
-/* Temperature calibration registers (BME680) */
-#define DIG_T1_LSB 0xE9
-#define DIG_T2_LSB 0x8A
-#define DIG_T3     0x8C
+/* Sample period without the adaptive controller */
+#define SAMPLE_PERIOD_MS 3000
+
+/* One sample, as it moves from acquisition through processing to output */
+struct lab3_sample {
+#ifdef CONFIG_APP_BME680_SEQ
+    struct bme680_data d;
+    size_t prof;
+#else
+    int32_t adc_T;
+#endif
+    int32_t t01;
+    uint32_t t_ms;      // k_uptime_get_32() at acquisition
+};
+
+static const struct device *i2c_dev;
+
+#ifdef CONFIG_APP_BME680_SEQ
+/* One per forced measurement, in turn; 0 C = T/P/H only */
+static const struct bme680_heater_profile heater_profiles[] = {
+    { 0, 0 },
+    { 200, 100 },
+    { 300, 100 },
+    { 320, 150 },
+};
+
+static struct bme680_raw bme;
+static struct bme680_seq seq;
+#endif
+
+/* Runtime statistics ("stats show sensor" with CONFIG_APP_STATS) */
+APP_STAT_COUNTER_DEFINE(st_samples, "sensor.samples");
+APP_STAT_COUNTER_DEFINE(st_errors, "sensor.errors");
+APP_STAT_HIST_DEFINE(st_fetch, "sensor.fetch", "us");
+APP_STAT_HIST_DEFINE(st_process, "sensor.process", "us");
+
+/* ===================== Stages ===================== */
+#ifdef CONFIG_APP_BME680_SEQ
+static uint32_t measured;
+#else
+static struct bme680_temp bme;
+#endif
+
+#ifdef CONFIG_APP_ADAPTIVE_RATE
+static struct adaptive_rate rate;
+#endif
+
+#ifdef CONFIG_APP_SAMPLE_LOG
+static uint32_t logged;
+#endif
+
+static int sensor_init(void)
+{
+#ifdef CONFIG_APP_BME680_SEQ
+    const struct bme680_raw_cfg bme_cfg = {
+        .os_t = CONFIG_APP_BME680_SEQ_OS_T,
+        .os_p = CONFIG_APP_BME680_SEQ_OS_P,
+        .os_h = CONFIG_APP_BME680_SEQ_OS_H,
+        .filter = CONFIG_APP_BME680_SEQ_FILTER,
+    };
+
+    if (bme680_raw_init(&bme, i2c_dev, BME680_ADDR) != 0 ||
+        bme680_raw_configure(&bme, &bme_cfg) != 0 ||
+        bme680_seq_start(&seq, &bme, heater_profiles, ARRAY_SIZE(heater_profiles)) != 0) {
+        return -1;
+    }
+#else
+    /* Temperature calibration; humidity oversampling = 0 */
+    if (bme680_temp_init(&bme, i2c_dev, BME680_ADDR) != 0) return -1;
+#endif
+    return 0;
+}
+
+/* Bus traffic and the conversion wait */
+static int sample_read(struct lab3_sample *s)
+{
+#ifdef CONFIG_APP_BME680_SEQ
+    /* Next heater profile; its successor is configured during the conversion */
+    return bme680_seq_step(&seq, &s->d, &s->prof);
+#else
+    /* Trigger one measurement (forced mode) */
+    (void)bme680_temp_trigger(&bme);
+    k_msleep(BME680_TEMP_WAIT_MS);
+
+    /* Read raw temperature (20-bit) */
+    return bme680_temp_read_adc(&bme, &s->adc_T) != 0 ? -1 : 0;
+#endif
+}
+
+static int sample_acquire(struct lab3_sample *s)
+{
+    uint32_t t0 = k_cycle_get_32();
+    int rc = sample_read(s);
 
-/* BME680 forced-mode, temp oversampling x1:
-   ctrl_meas: osrs_t[7:5]=001, mode[1:0]=01 -> (1<<5) | 0x01
-*/
-#define CTRL_MEAS_TEMP_X1_FORCED ((1u << 5) | 0x01)
+    s->t_ms = k_uptime_get_32();
+    app_stat_hist_record(&st_fetch, k_cyc_to_us_floor32(k_cycle_get_32() - t0));
+    app_stat_inc(rc == 0 ? &st_samples : &st_errors);
+    return rc;
+}
 
-static inline int rd8(const struct device *i2c, uint8_t reg, uint8_t *val)
+/* Compensation and everything that must see every sample; returns the next interval */
+static uint32_t sample_process(struct lab3_sample *s)
 {
-    return i2c_reg_read_byte(i2c, BME680_ADDR, reg, val);
+    uint32_t t0 = k_cycle_get_32();
+
+#ifdef CONFIG_APP_BME680_SEQ
+    s->t01 = s->d.temp;
+#else
+    s->t01 = bme680_temp_01C(&bme, s->adc_T);
+#endif
+    app_stat_hist_record(&st_process, k_cyc_to_us_floor32(k_cycle_get_32() - t0));
+
+#ifdef CONFIG_APP_SAMPLE_LOG
+    /* Keep the sample in flash as well */
+    if (sample_log_append(s->t01) == 0 && CONFIG_APP_SAMPLE_LOG_REPORT_EVERY > 0 &&
+        ++logged % CONFIG_APP_SAMPLE_LOG_REPORT_EVERY == 0) {
+        sample_log_print_stats();
+    }
+#if CONFIG_APP_SAMPLE_LOG_FLUSH_AGE_S > 0
+    /* bounds what a reboot loses while a slow rate fills the block */
+    sample_log_flush_older(CONFIG_APP_SAMPLE_LOG_FLUSH_AGE_S * 1000);
+#endif
+#endif
+
+#ifdef CONFIG_APP_ADAPTIVE_RATE
+    /* Interval runs from this sample to the next; it includes the conversion wait */
+    return adaptive_rate_update(&rate, s->t_ms, s->t01);
+#else
+    return SAMPLE_PERIOD_MS;
+#endif
 }
 
-static inline int rdN(const struct device *i2c, uint8_t start_reg, uint8_t *buf, size_t len)
+/* Formatting and the console */
+static void sample_output(const struct lab3_sample *s)
 {
-    return i2c_burst_read(i2c, BME680_ADDR, start_reg, buf, len);
+#ifdef CONFIG_APP_BME680_SEQ
+    printk("Temperature: %d.%02d C, pressure: %u Pa, humidity: %u.%03u %%, gas: %u ohm (profile %u)\n",
+           (int)(s->t01 / 100), (int)(s->t01 % 100), s->d.press, s->d.hum / 1000, s->d.hum % 1000,
+           s->d.gas, (unsigned)s->prof);
+
+    if (CONFIG_APP_BME680_SEQ_REPORT_EVERY > 0 &&
+        ++measured % CONFIG_APP_BME680_SEQ_REPORT_EVERY == 0) {
+        bme680_seq_print_stats(&seq);
+    }
+#else
+    printk("Temperature: %d.%02d C\n", (int)(s->t01 / 100), (int)(s->t01 % 100));
+#endif
 }
 
-static inline int wr8(const struct device *i2c, uint8_t reg, uint8_t val)
+#ifdef CONFIG_APP_PIPELINE
+BUILD_ASSERT(sizeof(struct lab3_sample) <= CONFIG_APP_PIPELINE_PAYLOAD_SIZE,
+             "raise CONFIG_APP_PIPELINE_PAYLOAD_SIZE");
+
+static int pipe_acquire(struct pipeline_sample *p)
 {
-    return i2c_reg_write_byte(i2c, BME680_ADDR, reg, val);
+    return sample_acquire((struct lab3_sample *)p->payload);
 }
 
-/* Returns temperature in 0.01 C (Bosch compensation) */
-static int32_t temp_01C(int32_t adc_T, uint16_t T1, int16_t T2, int8_t T3)
+static uint32_t pipe_process(struct pipeline_sample *p)
 {
-    int32_t v1 = ((((adc_T >> 3) - ((int32_t)T1 << 1))) * (int32_t)T2) >> 11;
-    int32_t v2 = (((((adc_T >> 4) - (int32_t)T1) * ((adc_T >> 4) - (int32_t)T1)) >> 12) * (int32_t)T3) >> 14;
-    int32_t tf = v1 + v2;
-    return (tf * 5 + 128) >> 8;
+    return sample_process((struct lab3_sample *)p->payload);
 }
 
+static void pipe_output(const struct pipeline_sample *p)
+{
+    sample_output((const struct lab3_sample *)p->payload);
+}
+
+static const struct pipeline_ops pipe_ops = {
+    .acquire = pipe_acquire,
+    .process = pipe_process,
+    .output = pipe_output,
+};
+#endif
+
 int main(void)
 {
-    const struct device *i2c = DEVICE_DT_GET(I2C_NODE);
-    if (!device_is_ready(i2c)) {
+    i2c_dev = DEVICE_DT_GET(I2C_NODE);
+    if (!device_is_ready(i2c_dev)) {
         printk("i2c0 not ready\n");
         return -1;
     }
 
-    /* Read temperature calibration parameters */
-    uint8_t b[2];
-    uint16_t T1; int16_t T2; int8_t T3;
-
-    if (rdN(i2c, DIG_T1_LSB, b, 2) != 0) return -1;
-    T1 = (uint16_t)(b[0] | (b[1] << 8));
+    if (sensor_init() != 0) {
+        printk("bme680 setup failed\n");
+        return -1;
+    }
 
-    if (rdN(i2c, DIG_T2_LSB, b, 2) != 0) return -1;
-    T2 = (int16_t)(b[0] | (b[1] << 8));
+#ifdef CONFIG_APP_ADAPTIVE_RATE
+    const struct adaptive_rate_cfg rate_cfg = {
+        .min_interval_ms = CONFIG_APP_ADAPTIVE_RATE_MIN_MS,
+        .max_interval_ms = CONFIG_APP_ADAPTIVE_RATE_MAX_MS,
+        .tolerance = CONFIG_APP_ADAPTIVE_RATE_TOLERANCE,
+    };
+    adaptive_rate_init(&rate, &rate_cfg);
+#endif
 
-    if (rd8(i2c, DIG_T3, (uint8_t *)&T3) != 0) return -1;
+#ifdef CONFIG_APP_SAMPLE_LOG
+    if (sample_log_init() != 0) {
+        printk("sample log unavailable\n");
+    }
+#endif
 
-    /* Minimal config: humidity oversampling = 0 */
-    (void)wr8(i2c, BME680_CTRL_HUM, 0x00);
+#ifdef CONFIG_APP_PIPELINE
+    /* Acquisition, processing and output each get a thread from here on */
+    if (pipeline_start(&pipe_ops, SAMPLE_PERIOD_MS) != 0) {
+        printk("pipeline start failed\n");
+        return -1;
+    }
 
+    while (CONFIG_APP_PIPELINE_REPORT_SEC > 0) {
+        k_sleep(K_SECONDS(CONFIG_APP_PIPELINE_REPORT_SEC));
+        pipeline_print_stats();
+    }
+    return 0;
+#else
     while (1) {
-        /* Trigger one measurement (forced mode) */
-        (void)wr8(i2c, BME680_CTRL_MEAS, CTRL_MEAS_TEMP_X1_FORCED);
-        k_msleep(200);
+        uint32_t start_ms = k_uptime_get_32();
+        struct lab3_sample s;
 
-        /* Read raw temperature (20-bit) */
-        uint8_t t[3];
-        if (rdN(i2c, BME680_TEMP_MSB, t, 3) != 0) {
+        if (sample_acquire(&s) != 0) {
             k_sleep(K_SECONDS(3));
             continue;
         }
-        /* t[0] : T[19:12]
-           t[1] : T[11:4]
-           t[2] : T[3:0] 
-        */
-        int32_t adc_T = ((int32_t)t[0] << 12) | ((int32_t)t[1] << 4) | ((int32_t)t[2] >> 4);
-        int32_t t01 = temp_01C(adc_T, T1, T2, T3);
-
-        printk("Temperature: %d.%02d C\n", (int)(t01 / 100), (int)(t01 % 100));
-        k_sleep(K_SECONDS(3));
+
+        uint32_t next_ms = sample_process(&s);
+        sample_output(&s);
+
+        uint32_t spent_ms = k_uptime_get_32() - start_ms;
+        k_msleep(next_ms > spent_ms ? next_ms - spent_ms : 0);
     }
+#endif
 }
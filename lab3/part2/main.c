@@ -4,36 +4,190 @@
 #include <zephyr/drivers/sensor.h>
 #include <zephyr/sys/printk.h>
 
+#include "app_stats.h"
+
+#ifdef CONFIG_APP_SAMPLE_LOG
+#include "sample_log.h"
+#endif
+
+#ifdef CONFIG_APP_ADAPTIVE_RATE
+#include "adaptive_rate.h"
+#endif
+
+#ifdef CONFIG_APP_PIPELINE
+#include "sensor_pipeline.h"
+#endif
+
 #define BME_NODE DT_NODELABEL(bme680)
 
+/* Sample period without the adaptive controller */
+#define SAMPLE_PERIOD_MS 3000
+
+/* One sample, as it moves from acquisition through processing to output */
+struct lab3_sample {
+    struct sensor_value temp;
+    int32_t t01;
+    uint32_t t_ms;      // k_uptime_get_32() at acquisition
+};
+
+static const struct device *dev;
+
+#ifdef CONFIG_APP_ADAPTIVE_RATE
+static struct adaptive_rate rate;
+#endif
+
+#ifdef CONFIG_APP_SAMPLE_LOG
+static uint32_t logged;
+#endif
+
+/* Runtime statistics ("stats show sensor" with CONFIG_APP_STATS) */
+APP_STAT_COUNTER_DEFINE(st_samples, "sensor.samples");
+APP_STAT_COUNTER_DEFINE(st_errors, "sensor.errors");
+APP_STAT_HIST_DEFINE(st_fetch, "sensor.fetch", "us");
+APP_STAT_HIST_DEFINE(st_process, "sensor.process", "us");
+
+/* ===================== Stages ===================== */
+/* Bus traffic; the driver also compensates inside sensor_sample_fetch() */
+static int sample_read(struct lab3_sample *s)
+{
+    /* 1) Ask driver to fetch a new sample (driver performs I2C ops + compensation internally) */
+    if (sensor_sample_fetch(dev) < 0) {
+        printk("sensor_sample_fetch failed\n");
+        return -1;
+    }
+
+    /* 2) Get the temperature channel */
+    if (sensor_channel_get(dev, SENSOR_CHAN_AMBIENT_TEMP, &s->temp) < 0) {
+        printk("sensor_channel_get failed\n");
+        return -1;
+    }
+    return 0;
+}
+
+static int sample_acquire(struct lab3_sample *s)
+{
+    uint32_t t0 = k_cycle_get_32();
+    int rc = sample_read(s);
+
+    s->t_ms = k_uptime_get_32();
+    app_stat_hist_record(&st_fetch, k_cyc_to_us_floor32(k_cycle_get_32() - t0));
+    app_stat_inc(rc == 0 ? &st_samples : &st_errors);
+    return rc;
+}
+
+/* Everything that must see every sample; returns the next interval */
+static uint32_t sample_process(struct lab3_sample *s)
+{
+    uint32_t t0 = k_cycle_get_32();
+
+    /* 0.01 C, the unit of part1 and of the lab3/common modules */
+    s->t01 = s->temp.val1 * 100 + s->temp.val2 / 10000;
+    app_stat_hist_record(&st_process, k_cyc_to_us_floor32(k_cycle_get_32() - t0));
+
+#ifdef CONFIG_APP_SAMPLE_LOG
+    /* Keep the sample in flash as well */
+    if (sample_log_append(s->t01) == 0 && CONFIG_APP_SAMPLE_LOG_REPORT_EVERY > 0 &&
+        ++logged % CONFIG_APP_SAMPLE_LOG_REPORT_EVERY == 0) {
+        sample_log_print_stats();
+    }
+#if CONFIG_APP_SAMPLE_LOG_FLUSH_AGE_S > 0
+    /* bounds what a reboot loses while a slow rate fills the block */
+    sample_log_flush_older(CONFIG_APP_SAMPLE_LOG_FLUSH_AGE_S * 1000);
+#endif
+#endif
+
+#ifdef CONFIG_APP_ADAPTIVE_RATE
+    /* Interval runs from this sample to the next; it includes the fetch */
+    return adaptive_rate_update(&rate, s->t_ms, s->t01);
+#else
+    return SAMPLE_PERIOD_MS;
+#endif
+}
+
+/* Formatting and the console */
+static void sample_output(const struct lab3_sample *s)
+{
+    /* sensor_value: val1 is integer part, val2 is fractional part in 1e-6 */
+    printk("Temperature: %d.%06d C\n", s->temp.val1, s->temp.val2);
+}
+
+#ifdef CONFIG_APP_PIPELINE
+BUILD_ASSERT(sizeof(struct lab3_sample) <= CONFIG_APP_PIPELINE_PAYLOAD_SIZE,
+             "raise CONFIG_APP_PIPELINE_PAYLOAD_SIZE");
+
+static int pipe_acquire(struct pipeline_sample *p)
+{
+    return sample_acquire((struct lab3_sample *)p->payload);
+}
+
+static uint32_t pipe_process(struct pipeline_sample *p)
+{
+    return sample_process((struct lab3_sample *)p->payload);
+}
+
+static void pipe_output(const struct pipeline_sample *p)
+{
+    sample_output((const struct lab3_sample *)p->payload);
+}
+
+static const struct pipeline_ops pipe_ops = {
+    .acquire = pipe_acquire,
+    .process = pipe_process,
+    .output = pipe_output,
+};
+#endif
+
 int main(void)
 {
-    const struct device *dev = DEVICE_DT_GET(BME_NODE);
+    dev = DEVICE_DT_GET(BME_NODE);
 
     if (!device_is_ready(dev)) {
         printk("BME680 device not ready\n");
         return -1;
     }
 
+#ifdef CONFIG_APP_ADAPTIVE_RATE
+    const struct adaptive_rate_cfg rate_cfg = {
+        .min_interval_ms = CONFIG_APP_ADAPTIVE_RATE_MIN_MS,
+        .max_interval_ms = CONFIG_APP_ADAPTIVE_RATE_MAX_MS,
+        .tolerance = CONFIG_APP_ADAPTIVE_RATE_TOLERANCE,
+    };
+    adaptive_rate_init(&rate, &rate_cfg);
+#endif
+
+#ifdef CONFIG_APP_SAMPLE_LOG
+    if (sample_log_init() != 0) {
+        printk("sample log unavailable\n");
+    }
+#endif
+
+#ifdef CONFIG_APP_PIPELINE
+    /* Acquisition, processing and output each get a thread from here on */
+    if (pipeline_start(&pipe_ops, SAMPLE_PERIOD_MS) != 0) {
+        printk("pipeline start failed\n");
+        return -1;
+    }
+
+    while (CONFIG_APP_PIPELINE_REPORT_SEC > 0) {
+        k_sleep(K_SECONDS(CONFIG_APP_PIPELINE_REPORT_SEC));
+        pipeline_print_stats();
+    }
+    return 0;
+#else
     while (1) {
-        /* 1) Ask driver to fetch a new sample (driver performs I2C ops + compensation internally) */
-        if (sensor_sample_fetch(dev) < 0) {
-            printk("sensor_sample_fetch failed\n");
-            k_sleep(K_SECONDS(3));
-            continue;
-        }
+        uint32_t start_ms = k_uptime_get_32();
+        struct lab3_sample s;
 
-        /* 2) Get the temperature channel */
-        struct sensor_value temp;
-        if (sensor_channel_get(dev, SENSOR_CHAN_AMBIENT_TEMP, &temp) < 0) {
-            printk("sensor_channel_get failed\n");
+        if (sample_acquire(&s) != 0) {
             k_sleep(K_SECONDS(3));
             continue;
         }
 
-        /* sensor_value: val1 is integer part, val2 is fractional part in 1e-6 */
-        printk("Temperature: %d.%06d C\n", temp.val1, temp.val2);
+        uint32_t next_ms = sample_process(&s);
+        sample_output(&s);
 
-        k_sleep(K_SECONDS(3));
+        uint32_t spent_ms = k_uptime_get_32() - start_ms;
+        k_msleep(next_ms > spent_ms ? next_ms - spent_ms : 0);
     }
+#endif
 }
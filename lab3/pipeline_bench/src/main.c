@@ -0,0 +1,123 @@
+/*
+ * Sequential loop vs sensor_pipeline.c on native_sim.
+ *
+ * The sensor and the console are emulated from their timing alone:
+ * acquisition busy-waits CONFIG_BENCH_BUS_US for the I2C transfer and
+ * sleeps CONFIG_BENCH_CONVERSION_US for the conversion; output formats
+ * the line and busy-waits as long as a polled UART at
+ * CONFIG_BENCH_CONSOLE_BAUD would take to send it. Each mode runs for
+ * CONFIG_BENCH_SECONDS at a CONFIG_BENCH_PERIOD_MS sample period and the
+ * achieved rates are printed.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <stdio.h>
+
+#include "sensor_pipeline.h"
+
+struct bench_sample {
+    uint32_t raw;
+    int32_t t01;
+};
+
+BUILD_ASSERT(sizeof(struct bench_sample) <= CONFIG_APP_PIPELINE_PAYLOAD_SIZE,
+             "raise CONFIG_APP_PIPELINE_PAYLOAD_SIZE");
+
+static uint32_t next_raw;
+
+/* ===================== Emulated stages ===================== */
+static int sample_acquire(struct bench_sample *s)
+{
+    k_busy_wait(CONFIG_BENCH_BUS_US);
+    k_usleep(CONFIG_BENCH_CONVERSION_US);
+    s->raw = next_raw++;
+    return 0;
+}
+
+static uint32_t sample_process(struct bench_sample *s)
+{
+    s->t01 = 2250 + (int32_t)(s->raw % 50);
+    return CONFIG_BENCH_PERIOD_MS;
+}
+
+static void sample_output(const struct bench_sample *s)
+{
+    char line[64];
+    int len = snprintf(line, sizeof(line), "Temperature: %d.%02d C\n",
+                       (int)(s->t01 / 100), (int)(s->t01 % 100));
+
+    /* 10 bits per character on the wire */
+    k_busy_wait((uint32_t)((uint64_t)len * 10 * 1000000 / CONFIG_BENCH_CONSOLE_BAUD));
+}
+
+static int pipe_acquire(struct pipeline_sample *p)
+{
+    return sample_acquire((struct bench_sample *)p->payload);
+}
+
+static uint32_t pipe_process(struct pipeline_sample *p)
+{
+    return sample_process((struct bench_sample *)p->payload);
+}
+
+static void pipe_output(const struct pipeline_sample *p)
+{
+    sample_output((const struct bench_sample *)p->payload);
+}
+
+static const struct pipeline_ops pipe_ops = {
+    .acquire = pipe_acquire,
+    .process = pipe_process,
+    .output = pipe_output,
+};
+
+/* ===================== Modes ===================== */
+/* the lab3 main() loop before the pipeline */
+static void run_sequential(void)
+{
+    int64_t end = k_uptime_get() + CONFIG_BENCH_SECONDS * 1000;
+    uint32_t n = 0, max_gap_ms = 0;
+    int64_t last = 0;
+
+    while (k_uptime_get() < end) {
+        int64_t start = k_uptime_get();
+        struct bench_sample s;
+
+        sample_acquire(&s);
+        if (n && start - last > max_gap_ms) max_gap_ms = (uint32_t)(start - last);
+        last = start;
+        n++;
+
+        uint32_t next_ms = sample_process(&s);
+        sample_output(&s);
+
+        uint32_t spent_ms = (uint32_t)(k_uptime_get() - start);
+        k_msleep(next_ms > spent_ms ? next_ms - spent_ms : 0);
+    }
+
+    uint32_t x100 = n * 100 / CONFIG_BENCH_SECONDS;
+    printk("sequential: %u samples, %u.%02u samples/s (acquired = output), max period %u ms\n",
+           n, x100 / 100, x100 % 100, max_gap_ms);
+}
+
+static void run_pipeline(void)
+{
+    if (pipeline_start(&pipe_ops, CONFIG_BENCH_PERIOD_MS) != 0) {
+        printk("pipeline start failed\n");
+        return;
+    }
+    k_sleep(K_SECONDS(CONFIG_BENCH_SECONDS));
+    pipeline_print_stats();
+}
+
+int main(void)
+{
+    printk("period %u ms, bus %u us, conversion %u us, console %u baud, %u s per mode\n",
+           CONFIG_BENCH_PERIOD_MS, CONFIG_BENCH_BUS_US, CONFIG_BENCH_CONVERSION_US,
+           CONFIG_BENCH_CONSOLE_BAUD, CONFIG_BENCH_SECONDS);
+
+    run_sequential();
+    run_pipeline();
+    return 0;
+}
@@ -0,0 +1,221 @@
+/*
+ * Round trip through lab3/common/sample_log.c on the flash simulator.
+ *
+ * Each test starts from an erased storage_partition. Samples are appended
+ * at CONFIG_TEST_PERIOD_MS of simulated time, then read back whole, by
+ * time range, through export + sample_log_decode_block(), and again after
+ * a simulated reboot (sample_log_init() on the same flash). A second test
+ * appends until the log wraps and checks that what is left is the newest
+ * samples, unbroken. The round trip prints the compression ratio and
+ * flash writes per 1000 samples of its run.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/ztest.h>
+
+#include "sample_log.h"
+
+#define MAX_SAMPLES MAX(CONFIG_TEST_SAMPLES, CONFIG_TEST_WRAP_MAX_SAMPLES)
+
+/* what went in: k_uptime_get_32() at each append, and the value */
+static uint32_t up_ms[MAX_SAMPLES];
+static int32_t values[MAX_SAMPLES];
+static uint32_t appended;
+
+/* log time = uptime + offset, fixed for one boot */
+static uint32_t offset_ms;
+
+static int32_t value_of(uint32_t i)
+{
+    /* slow triangle in 0.01 C with a little noise, like a room */
+    uint32_t phase = (i / 8) % 400;
+    int32_t ramp = phase < 200 ? (int32_t)phase : 400 - (int32_t)phase;
+    uint32_t noise = (i * 1103515245u + 12345u) >> 16;
+
+    return 2150 + ramp + (int32_t)(noise % 5) - 2;
+}
+
+static int first_cb(const struct sample_log_sample *s, void *arg)
+{
+    *(uint32_t *)arg = s->t_ms;
+    return 1;
+}
+
+static void append(uint32_t count)
+{
+    for (uint32_t n = 0; n < count; n++) {
+        uint32_t i = appended++;
+
+        values[i] = value_of(i);
+        up_ms[i] = k_uptime_get_32();
+        zassert_ok(sample_log_append(values[i]), "append %u", i);
+
+        if (i == 0) {
+            uint32_t t;
+            zassert_ok(sample_log_read(0, UINT32_MAX, first_cb, &t));
+            offset_ms = t - up_ms[0];
+        }
+        k_msleep(CONFIG_TEST_PERIOD_MS);
+    }
+}
+
+/* ===================== Read-back checks ===================== */
+struct expect {
+    uint32_t next;      // index of the next sample expected
+    uint32_t seen;
+    bool bad;
+};
+
+static int check_cb(const struct sample_log_sample *s, void *arg)
+{
+    struct expect *e = arg;
+    uint32_t i = e->next++;
+
+    e->seen++;
+    if (i >= appended || s->t_ms != up_ms[i] + offset_ms || s->value != values[i]) {
+        if (!e->bad) {
+            printk("sample %u: got t=%u v=%d, want t=%u v=%d\n", i, s->t_ms, s->value,
+                   i < appended ? up_ms[i] + offset_ms : 0, i < appended ? values[i] : 0);
+        }
+        e->bad = true;
+        return 1;
+    }
+    return 0;
+}
+
+static void check_range(uint32_t from, uint32_t to)
+{
+    struct expect e = { .next = from };
+
+    zassert_ok(sample_log_read(up_ms[from] + offset_ms, up_ms[to] + offset_ms, check_cb, &e));
+    zassert_false(e.bad, "range %u..%u: wrong sample", from, to);
+    zassert_equal(e.seen, to - from + 1, "range %u..%u: %u samples", from, to, e.seen);
+}
+
+struct export_ctx {
+    struct expect e;
+    uint32_t blocks;
+    uint32_t bytes;
+};
+
+static int export_cb(const uint8_t *block, size_t len, void *arg)
+{
+    struct export_ctx *ctx = arg;
+
+    ctx->blocks++;
+    ctx->bytes += len;
+    return sample_log_decode_block(block, len, check_cb, &ctx->e);
+}
+
+/* ===================== Tests ===================== */
+static void *setup(void)
+{
+    const struct flash_area *fa;
+
+    zassert_ok(flash_area_open(FIXED_PARTITION_ID(storage_partition), &fa));
+    printk("storage_partition: %u bytes\n", (unsigned)fa->fa_size);
+    flash_area_close(fa);
+    return NULL;
+}
+
+static void before(void *fixture)
+{
+    const struct flash_area *fa;
+
+    ARG_UNUSED(fixture);
+    zassert_ok(flash_area_open(FIXED_PARTITION_ID(storage_partition), &fa));
+    zassert_ok(flash_area_erase(fa, 0, fa->fa_size));
+    flash_area_close(fa);
+
+    zassert_ok(sample_log_init());
+    appended = 0;
+}
+
+ZTEST(sample_log, test_round_trip)
+{
+    const uint32_t n = CONFIG_TEST_SAMPLES;
+    struct sample_log_stats before_st, st;
+
+    sample_log_get_stats(&before_st);
+    append(n);
+    zassert_ok(sample_log_flush());
+    sample_log_get_stats(&st);
+    zassert_equal(st.flash_erases, before_st.flash_erases, "log wrapped, lower TEST_SAMPLES");
+
+    /* everything, then a slice from the middle */
+    check_range(0, n - 1);
+    check_range(n / 3, n / 3 + n / 4);
+    check_range(n - 1, n - 1);
+
+    /* export hands out every block still encoded */
+    struct export_ctx ex = { .e = { .next = 0 } };
+
+    zassert_ok(sample_log_export(export_cb, &ex));
+    zassert_false(ex.e.bad, "export: wrong sample");
+    zassert_equal(ex.e.seen, n, "export: %u samples", ex.e.seen);
+    zassert_equal(ex.blocks, st.blocks - before_st.blocks, "export: %u blocks", ex.blocks);
+    zassert_equal(ex.bytes, st.stored_bytes - before_st.stored_bytes, "export: %u bytes", ex.bytes);
+
+    /* this run's figures */
+    uint32_t samples = st.samples - before_st.samples;
+    uint32_t stored = st.stored_bytes - before_st.stored_bytes;
+    uint32_t writes = st.flash_writes - before_st.flash_writes;
+    uint32_t ratio_x100 = (uint32_t)((uint64_t)samples * sizeof(struct sample_log_sample) * 100 /
+                                     stored);
+
+    printk("round trip: %u samples at %u ms in %u blocks, %u bytes, ratio %u.%02u:1, "
+           "%u flash writes/1000 samples\n", samples, CONFIG_TEST_PERIOD_MS, ex.blocks, stored,
+           ratio_x100 / 100, ratio_x100 % 100, writes * 1000 / samples);
+
+    /* a reboot rebuilds the index from flash; log time carries on */
+    uint32_t last = up_ms[n - 1] + offset_ms;
+
+    zassert_ok(sample_log_init());
+    check_range(0, n - 1);
+
+    uint32_t t_after;
+
+    zassert_ok(sample_log_append(value_of(n)));
+    zassert_ok(sample_log_read(last + 1, UINT32_MAX, first_cb, &t_after));
+    zassert_true(t_after > last, "log time went back after the reboot");
+    zassert_ok(sample_log_flush());
+}
+
+static int tail_cb(const struct sample_log_sample *s, void *arg)
+{
+    struct expect *e = arg;
+
+    /* the first sample left decides where the check starts */
+    if (e->seen == 0) {
+        while (e->next < appended && up_ms[e->next] + offset_ms < s->t_ms) {
+            e->next++;
+        }
+    }
+    return check_cb(s, arg);
+}
+
+ZTEST(sample_log, test_wrap)
+{
+    struct sample_log_stats st0, st;
+
+    sample_log_get_stats(&st0);
+    do {
+        append(100);
+        sample_log_get_stats(&st);
+    } while (st.flash_erases == st0.flash_erases && appended + 100 <= MAX_SAMPLES);
+    zassert_true(st.flash_erases > st0.flash_erases, "log never wrapped");
+    zassert_ok(sample_log_flush());
+
+    /* the oldest sector is gone; the rest runs unbroken to the newest */
+    struct expect e = { .next = 0 };
+
+    zassert_ok(sample_log_read(0, UINT32_MAX, tail_cb, &e));
+    zassert_false(e.bad, "wrapped log: wrong sample");
+    zassert_true(e.next > e.seen, "wrapped log kept every sample");
+    zassert_equal(e.next, appended, "wrapped log: ends at %u of %u", e.next, appended);
+    printk("wrap: %u samples appended, newest %u kept\n", appended, e.seen);
+}
+
+ZTEST_SUITE(sample_log, NULL, setup, before, NULL, NULL);
@@ -0,0 +1,238 @@
+/*
+ * lab3 shared-bus scheduler (lab3/common/bus_sched.c) on stub sensors.
+ *
+ *   bus_sched_bench
+ *
+ * bus_sched.c runs unmodified against the kernel shim in shim/, on a
+ * virtual clock. A stub sensor's trigger and read each hold the bus for a
+ * fixed time, and its read returns -EBUSY until conversion_us after the
+ * trigger, as a forced-mode BME680 would.
+ *
+ * Checks (exit status 1 on any failure):
+ *   - every run: each release is either triggered or counted as an
+ *     overrun, each trigger ends as a sample or an error unless still in
+ *     flight, and the bus time adds up to the stub operations
+ *   - four sensors at the bus_bench overlay's rates, interleaved: every
+ *     rate met, no overruns, no errors, triggers late by at most one
+ *     read plus the other sensors' triggers
+ *   - the same sensors as the serial baseline: overruns
+ *   - one sensor converting for 2.5 periods: the releases each sample
+ *     passes entirely counted as overruns, the last one it overlaps
+ *     triggered late, both matching a model of the schedule
+ *   - two sensors released together: the second trigger of each pair
+ *     late by exactly the first one's trigger
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "bus_sched.h"
+
+#define TRIGGER_US  100
+#define READ_US     400
+
+int64_t bench_now_us;
+
+static unsigned failures;
+
+static void check(bool ok, const char *fmt, const char *name)
+{
+    if (!ok) {
+        printf("  FAIL: ");
+        printf(fmt, name);
+        printf("\n");
+        failures++;
+    }
+}
+
+/* ===================== Stub sensor ===================== */
+struct stub {
+    int64_t ready_us;       // conversion done
+    uint32_t reads;
+};
+
+static int stub_trigger(struct bus_sched_dev *dev)
+{
+    struct stub *st = dev->ctx;
+
+    bench_now_us += TRIGGER_US;
+    st->ready_us = bench_now_us + dev->conversion_us;
+    return 0;
+}
+
+static int stub_read(struct bus_sched_dev *dev)
+{
+    struct stub *st = dev->ctx;
+
+    bench_now_us += READ_US;
+    st->reads++;
+    return bench_now_us < st->ready_us ? -EBUSY : 0;
+}
+
+static const struct bus_sched_ops stub_ops = { stub_trigger, stub_read };
+
+/* ===================== Runs ===================== */
+#define MAX_DEVS 4
+
+typedef struct {
+    const char *name;
+    uint32_t period_us;
+    uint32_t conversion_us;
+} sensor_t;
+
+/* the lab3/bus_bench overlay, with the x1..x16 conversion each budget gets */
+static const sensor_t bench_sensors[] = {
+    { "env_a",  50000,  28849 },
+    { "env_b", 100000,  52405 },
+    { "env_c", 200000,  17071 },
+    { "env_d", 250000,  99517 },
+};
+
+static struct bus_sched_dev devs[MAX_DEVS];
+static struct stub stubs[MAX_DEVS];
+
+static void run(struct bus_sched *s, const sensor_t *sensors, size_t n, bool serial,
+                uint32_t duration_ms)
+{
+    memset(devs, 0, sizeof(devs));
+    memset(stubs, 0, sizeof(stubs));
+    for (size_t i = 0; i < n; i++) {
+        devs[i].name = sensors[i].name;
+        devs[i].ops = &stub_ops;
+        devs[i].ctx = &stubs[i];
+        devs[i].period_us = sensors[i].period_us;
+        devs[i].conversion_us = sensors[i].conversion_us;
+    }
+
+    bench_now_us = 0;
+    bus_sched_init(s, devs, n, serial);
+    bus_sched_run(s, duration_ms);
+    bus_sched_print_stats(s);
+
+    uint64_t bus_us = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        const struct bus_sched_dev *d = &devs[i];
+        const struct bus_sched_dev_stats *st = &d->stats;
+        uint64_t releases = (uint64_t)(d->release_us - s->start_us) / d->period_us;
+
+        check(releases == (uint64_t)st->triggers + st->overruns,
+              "%s: releases neither triggered nor counted as overruns", d->name);
+        check(st->samples + st->errors + (d->converting ? 1u : 0u) == st->triggers,
+              "%s: triggers lost between trigger and read", d->name);
+        check(st->bus_us == (uint64_t)st->triggers * TRIGGER_US + (uint64_t)stubs[i].reads * READ_US,
+              "%s: bus time does not match the stub operations", d->name);
+        bus_us += st->bus_us;
+    }
+    check(s->bus_us == bus_us, "%s: bus time is not the sum of the devices'", "bus");
+}
+
+static void interleaved_meets_rates(void)
+{
+    const size_t n = sizeof(bench_sensors) / sizeof(bench_sensors[0]);
+    const uint32_t duration_ms = 10000;
+    struct bus_sched s;
+
+    printf("bus_bench sensors, interleaved\n");
+    run(&s, bench_sensors, n, false, duration_ms);
+
+    for (size_t i = 0; i < n; i++) {
+        const struct bus_sched_dev_stats *st = &devs[i].stats;
+        uint32_t want = duration_ms * 1000 / devs[i].period_us;
+
+        check(st->triggers == want, "%s: missed releases", devs[i].name);
+        check(st->samples + 1 >= want, "%s: rate not met", devs[i].name);
+        check(st->overruns == 0, "%s: overruns", devs[i].name);
+        check(st->errors == 0, "%s: errors", devs[i].name);
+        check(st->max_late_us <= READ_US + (n - 1) * TRIGGER_US,
+              "%s: trigger later than one read plus the other triggers", devs[i].name);
+    }
+}
+
+static void serial_overruns(void)
+{
+    const size_t n = sizeof(bench_sensors) / sizeof(bench_sensors[0]);
+    struct bus_sched s;
+
+    printf("\nbus_bench sensors, serial\n");
+    run(&s, bench_sensors, n, true, 10000);
+
+    /* the fastest sensor waits out the others' conversions */
+    check(devs[0].stats.overruns > 0, "%s: serial baseline met the rate", devs[0].name);
+}
+
+static void overrun_accounting(void)
+{
+    /* every sample holds the device 25.4 ms from trigger to read: the
+       releases it passes entirely are overruns, the last one it overlaps
+       is triggered late, right after the read */
+    static const sensor_t slow[] = { { "slow", 10000, 25000 } };
+    const uint32_t period = slow[0].period_us, span = slow[0].conversion_us + READ_US;
+    const uint32_t duration_ms = 1000;
+    const struct bus_sched_dev_stats *st = &devs[0].stats;
+    struct bus_sched s;
+
+    printf("\nconversion of 2.5 periods\n");
+    run(&s, slow, 1, false, duration_ms);
+
+    uint32_t triggers = 0, overruns = 0, max_late = 0;
+    uint64_t late_sum = 0, release = 0;
+
+    for (uint64_t t = 0; t < duration_ms * 1000u; t += span) {
+        uint64_t r = t / period * period;
+
+        if (triggers) overruns += (uint32_t)((r - release) / period - 1);
+        release = r;
+        late_sum += t - r;
+        if (t - r > max_late) max_late = (uint32_t)(t - r);
+        triggers++;
+    }
+
+    check(st->triggers == triggers, "%s: triggers", "slow");
+    check(st->samples == triggers - 1, "%s: samples", "slow");   // the last still converting
+    check(st->overruns == overruns, "%s: overruns", "slow");
+    check(st->retries == 0, "%s: retries", "slow");
+    check(st->late_us == late_sum && st->max_late_us == max_late, "%s: late", "slow");
+    check(st->max_late_us < period, "%s: late by a whole period", "slow");
+    check(st->min_interval_us == span && st->max_interval_us == span, "%s: interval", "slow");
+}
+
+static void lateness_accounting(void)
+{
+    /* same release, same period: "first" triggers on time, "second"
+       after its TRIGGER_US; both reads fit well inside the period */
+    static const sensor_t pair[] = {
+        { "first",  10000, 2000 },
+        { "second", 10000, 2000 },
+    };
+    struct bus_sched s;
+
+    printf("\ntwo sensors released together\n");
+    run(&s, pair, 2, false, 1000);
+
+    for (size_t i = 0; i < 2; i++) {
+        const struct bus_sched_dev_stats *st = &devs[i].stats;
+        uint32_t late = i * TRIGGER_US;
+
+        check(st->triggers == 100 && st->samples == 100, "%s: rate not met", pair[i].name);
+        check(st->overruns == 0, "%s: overruns", pair[i].name);
+        check(st->late_us == (uint64_t)late * st->triggers && st->max_late_us == late,
+              "%s: late", pair[i].name);
+        check(st->min_interval_us == 10000 && st->max_interval_us == 10000,
+              "%s: interval", pair[i].name);
+    }
+}
+
+int main(void)
+{
+    interleaved_meets_rates();
+    serial_overruns();
+    overrun_accounting();
+    lateness_accounting();
+
+    printf("\n%s: %u failed check%s\n", failures ? "FAIL" : "PASS", failures,
+           failures == 1 ? "" : "s");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,37 @@
+#ifndef BUS_BENCH_SHIM_ZEPHYR_KERNEL_H
+#define BUS_BENCH_SHIM_ZEPHYR_KERNEL_H
+
+/*
+ * Host stand-in for the Zephyr kernel time APIs bus_sched.c uses, on a
+ * virtual clock (1 tick = 1 cycle = 1 us): sleeping and busy-waiting
+ * both just move the clock, so runs are exact and take no real time.
+ */
+
+#include <errno.h>
+#include <stdint.h>
+
+#define CONFIG_APP_BUS_SCHED_POLL_US 500
+
+extern int64_t bench_now_us;
+
+typedef struct {
+    int64_t abs_us;
+} k_timeout_t;
+
+#define K_TIMEOUT_ABS_TICKS(t) ((k_timeout_t){ (int64_t)(t) })
+
+static inline int64_t k_uptime_ticks(void)                { return bench_now_us; }
+static inline int64_t k_ticks_to_us_floor64(int64_t t)    { return t; }
+static inline int64_t k_us_to_ticks_ceil64(int64_t us)    { return us; }
+static inline uint32_t k_cycle_get_32(void)               { return (uint32_t)bench_now_us; }
+static inline uint32_t k_cyc_to_us_floor32(uint32_t cyc)  { return cyc; }
+static inline void k_busy_wait(uint32_t us)               { bench_now_us += us; }
+
+/* an absolute timeout already past returns at once, as in Zephyr */
+static inline int32_t k_sleep(k_timeout_t t)
+{
+    if (t.abs_us > bench_now_us) bench_now_us = t.abs_us;
+    return 0;
+}
+
+#endif /* BUS_BENCH_SHIM_ZEPHYR_KERNEL_H */
@@ -0,0 +1,8 @@
+#ifndef BUS_BENCH_SHIM_ZEPHYR_SYS_PRINTK_H
+#define BUS_BENCH_SHIM_ZEPHYR_SYS_PRINTK_H
+
+#include <stdio.h>
+
+#define printk printf
+
+#endif /* BUS_BENCH_SHIM_ZEPHYR_SYS_PRINTK_H */
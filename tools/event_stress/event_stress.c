@@ -0,0 +1,539 @@
+/*
+ * lab1 event handling under press storms, before and after event_queue.c.
+ *
+ *   event_stress [--seed N]
+ *
+ * Scripted presses go through the lab1 gesture recognizer (gesture.c,
+ * with the flags and timing of lab1.c) on a virtual clock; the gestures
+ * it emits are mapped to events the way lab1.c does and fed to the FSM
+ * (state table and per-state delays copied from lab1.c) in two modes:
+ *   - fifo:  the original 32-entry queue_t, new events silently dropped
+ *            when full, one event applied per loop iteration
+ *   - evq:   event_queue.c with lab1's policy, the whole batch applied
+ *            per loop iteration
+ * For each scenario it reports what was posted, what was dropped or
+ * merged, how many Exit/Enter transitions ran, how many events were
+ * applied more than STALE_MS after they were posted, and how long the
+ * FSM kept changing state after the last event.
+ *
+ * Checks (exit status 1 on any failure):
+ *   - queue contract: random post/take_all sequences on a policy with
+ *     plain, coalescing and preempting types in three classes; every
+ *     event that leaves the queue other than by delivery must be
+ *     coalesced, preempted by a higher class or the overflow victim,
+ *     delivery keeps arrival order, the depth never passes EVQ_CAPACITY,
+ *     and the stats add up
+ *   - lab1 scenarios, evq mode: nothing dropped, nothing stale, the last
+ *     event acts within one loop period, and the expected final state
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "event_queue.h"
+#include "gesture.h"
+
+#define FIFO_LEN     32
+#define STALE_MS     1000
+#define MAX_PRESSES  512
+#define MAX_EVENTS   1024
+#define FUZZ_OPS     200000
+
+/* ===================== lab1 configuration (copy of lab1.c) ===================== */
+enum { B1, B2, B3, B1_LONG, B2_LONG, B1_DBL, CHORD, N_EVT };
+
+static const char *const evt_names[N_EVT] = {
+    "b1", "b2", "b3", "b1 long", "b2 long", "b1 double", "chord",
+};
+
+static const uint32_t state_delay_ms[4] = { 500, 300, 100, 10 };
+
+static const uint8_t state_table[4][N_EVT] = {
+    /*       b1  b2  b3  b1l b2l b1d chord */
+    /* S0 */ { 2,  1,  3,  0,  1,  2,  3 },
+    /* S1 */ { 0,  2,  3,  0,  1,  1,  3 },
+    /* S2 */ { 1,  0,  3,  0,  1,  0,  3 },
+    /* S3 */ { 0,  0,  0,  0,  0,  0,  0 },
+};
+
+static const evq_policy_t lab1_policy[N_EVT] = {
+    [B1]      = { 0, EVQ_COALESCE },
+    [B2]      = { 0, EVQ_COALESCE },
+    [B3]      = { 1, EVQ_COALESCE | EVQ_PREEMPT },
+    [B1_LONG] = { 0, EVQ_COALESCE },
+    [B2_LONG] = { 0, EVQ_COALESCE },
+    [B1_DBL]  = { 0, EVQ_COALESCE },
+    [CHORD]   = { 1, EVQ_COALESCE | EVQ_PREEMPT },
+};
+
+static const uint8_t gesture_flags[] = {
+    GESTURE_LONG | GESTURE_DOUBLE | GESTURE_CHORD,  // b1
+    GESTURE_LONG | GESTURE_CHORD,                   // b2
+    0,                                              // b3
+};
+
+static const gesture_timing_t gesture_timing = { 50000, 600000, 250000, 80000 };
+
+static unsigned failures;
+
+static void check(bool ok, const char *what)
+{
+    if (!ok) {
+        printf("  FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+/* ===================== Scenarios ===================== */
+typedef struct {
+    uint32_t t_ms;
+    uint8_t btn;
+    uint16_t hold_ms;
+} press_t;
+
+typedef struct {
+    const char *name;
+    const char *desc;
+    size_t (*gen)(press_t *p);
+    int final_state;        // expected in evq mode, -1 = any
+} scenario_t;
+
+static uint32_t rng;
+static uint32_t rnd(uint32_t n)
+{
+    rng = rng * 1664525u + 1013904223u;
+    return (rng >> 8) % n;
+}
+
+/* 20 presses/s on random buttons for 5 s, starting in S0 (500 ms ticks) */
+static size_t gen_storm(press_t *p)
+{
+    size_t n = 0;
+    for (uint32_t t = 1000; t < 6000; t += 40 + rnd(20)) {
+        p[n].t_ms = t;
+        p[n].btn = (uint8_t)rnd(2);   // b1 / b2 only, b3 would reset to S0
+        p[n].hold_ms = 20;
+        n++;
+    }
+    return n;
+}
+
+/* someone leans on b1: 12 presses in 1 s */
+static size_t gen_repeat(press_t *p)
+{
+    size_t n = 0;
+    for (uint32_t t = 1000; n < 12; t += 85) {
+        p[n].t_ms = t;
+        p[n].btn = B1;
+        p[n].hold_ms = 30;
+        n++;
+    }
+    return n;
+}
+
+/* b1/b2 storm, then b3: the b3 should act at once */
+static size_t gen_storm_b3(press_t *p)
+{
+    size_t n = gen_storm(p);
+    p[n].t_ms = p[n - 1].t_ms + 60;
+    p[n].btn = B3;
+    p[n].hold_ms = 20;
+    return n + 1;
+}
+
+/* one of each gesture, spaced out: S1, S2, S0, S3, S0, S1 */
+static size_t gen_gestures(press_t *p)
+{
+    static const press_t script[] = {
+        { 1000, B2, 900 },      // b2 long   -> S1
+        { 3000, B2, 100 },      // b2 click  -> S2
+        { 5000, B1, 80 },       // b1 double -> S0
+        { 5200, B1, 80 },
+        { 7000, B1, 300 },      // chord     -> S3
+        { 7040, B2, 300 },
+        { 9000, B3, 50 },       // b3        -> S0
+        { 11000, B2, 1000 },    // b2 long   -> S1
+    };
+
+    memcpy(p, script, sizeof(script));
+    return sizeof(script) / sizeof(script[0]);
+}
+
+static const scenario_t scenarios[] = {
+    { "storm",    "20 presses/s on b1/b2 for 5 s", gen_storm,    -1 },
+    { "repeat",   "12 b1 presses in 1 s",          gen_repeat,   -1 },
+    { "storm+b3", "storm, then one b3 press",      gen_storm_b3, -1 },
+    { "gestures", "long, click, double, chord, b3, long", gen_gestures, 1 },
+};
+
+/* ===================== Presses to events ===================== */
+typedef struct {
+    uint32_t t_ms;
+    uint8_t type;
+} event_t;
+
+typedef struct {
+    event_t e[MAX_EVENTS];
+    size_t n;
+} event_list_t;
+
+typedef struct {
+    uint32_t t_us;
+    uint8_t btn;
+    bool pressed;
+} edge_t;
+
+/* lab1.c gesture_event() */
+static void gesture_event(void *ctx, gesture_kind_t kind, uint8_t buttons, uint32_t t_us)
+{
+    event_list_t *out = ctx;
+    uint8_t evt = B1;
+
+    switch (kind) {
+        case GESTURE_PRESS:
+        case GESTURE_CLICK:
+            evt = buttons == 0x1 ? B1 : buttons == 0x2 ? B2 : B3;
+            break;
+        case GESTURE_LONG_PRESS:
+            evt = buttons == 0x1 ? B1_LONG : B2_LONG;
+            break;
+        case GESTURE_DOUBLE_CLICK:
+            evt = B1_DBL;
+            break;
+        case GESTURE_CHORD_PRESS:
+            evt = CHORD;
+            break;
+    }
+    if (out->n < MAX_EVENTS) out->e[out->n++] = (event_t){ t_us / 1000, evt };
+}
+
+static int edge_cmp(const void *a, const void *b)
+{
+    const edge_t *x = a, *y = b;
+    return x->t_us < y->t_us ? -1 : x->t_us > y->t_us;
+}
+
+/* edges and recognizer deadlines in time order, edges first on a tie */
+static void recognize(const press_t *p, size_t n, event_list_t *out)
+{
+    static edge_t edges[2 * MAX_PRESSES];
+    gesture_t g;
+    size_t n_edges = 0, next = 0;
+    uint32_t t;
+
+    for (size_t i = 0; i < n; i++) {
+        edges[n_edges++] = (edge_t){ p[i].t_ms * 1000u, p[i].btn, true };
+        edges[n_edges++] = (edge_t){ (p[i].t_ms + p[i].hold_ms) * 1000u, p[i].btn, false };
+    }
+    qsort(edges, n_edges, sizeof(edges[0]), edge_cmp);
+
+    out->n = 0;
+    gesture_init(&g, gesture_flags, sizeof(gesture_flags), &gesture_timing, gesture_event, out);
+    for (;;) {
+        bool pending = gesture_next_deadline(&g, &t);
+
+        if (next < n_edges && (!pending || edges[next].t_us <= t)) {
+            gesture_edge(&g, edges[next].btn, edges[next].pressed, edges[next].t_us);
+            next++;
+        } else if (pending) {
+            gesture_expire(&g, t);
+        } else {
+            break;
+        }
+    }
+}
+
+/* ===================== Simulation ===================== */
+typedef struct {
+    uint32_t posted;
+    uint32_t dropped;       // lost on a full queue
+    uint32_t merged;        // coalesced or preempted
+    uint32_t applied;       // events walked through the state table
+    uint32_t transitions;   // Exit/Enter pairs run
+    uint32_t stale;         // applied more than STALE_MS after posting
+    uint32_t max_age_ms;
+    uint32_t last_age_ms;   // of the last event posted, if applied
+    uint32_t settle_ms;     // last state change after the last event
+    uint32_t max_depth;
+    uint8_t final_state;
+} result_t;
+
+/* the original FIFO, the way queue_try_add() fails when full */
+typedef struct {
+    evq_entry_t e[FIFO_LEN];
+    uint32_t head, count;
+} fifo_t;
+
+static void apply(result_t *r, uint8_t *state, const evq_entry_t *e, uint32_t now,
+                  uint32_t last_ms)
+{
+    uint32_t age = now - e->t_ms;
+
+    *state = state_table[*state][e->type];
+    r->applied++;
+    if (age > STALE_MS) r->stale++;
+    if (age > r->max_age_ms) r->max_age_ms = age;
+    if (e->t_ms == last_ms) r->last_age_ms = age;
+}
+
+static result_t run(const event_list_t *ev, bool use_evq)
+{
+    result_t r = { 0 };
+    evq_t q;
+    fifo_t fifo = { 0 };
+    uint8_t state = 0;
+    uint32_t now = 0, last_ms = ev->e[ev->n - 1].t_ms, last_change = 0;
+    size_t next = 0;
+
+    r.last_age_ms = UINT32_MAX;
+    evq_init(&q, lab1_policy, N_EVT);
+
+    /* the main loop: Do, sleep_ms(delay), then events; ISRs land during the sleep */
+    while (now < last_ms + 10000) {
+        uint32_t wake = now + state_delay_ms[state];
+
+        for (; next < ev->n && ev->e[next].t_ms < wake; next++) {
+            evq_entry_t e = { ev->e[next].type, ev->e[next].t_ms };
+            r.posted++;
+
+            if (use_evq) {
+                evq_post(&q, e.type, e.t_ms);
+            } else if (fifo.count < FIFO_LEN) {
+                fifo.e[(fifo.head + fifo.count++) % FIFO_LEN] = e;
+                if (fifo.count > r.max_depth) r.max_depth = fifo.count;
+            } else {
+                r.dropped++;
+            }
+        }
+        now = wake;
+
+        uint8_t before = state;
+        if (use_evq) {
+            evq_entry_t evts[EVQ_CAPACITY];
+            size_t k = evq_take_all(&q, evts, EVQ_CAPACITY);
+            for (size_t i = 0; i < k; i++) apply(&r, &state, &evts[i], now, last_ms);
+        } else if (fifo.count) {
+            evq_entry_t e = fifo.e[fifo.head];
+            fifo.head = (fifo.head + 1) % FIFO_LEN;
+            fifo.count--;
+            apply(&r, &state, &e, now, last_ms);
+        }
+
+        if (state != before) {
+            r.transitions++;
+            last_change = now;
+        }
+    }
+
+    if (use_evq) {
+        r.dropped = q.stats.overflow;
+        r.merged = q.stats.coalesced + q.stats.preempted;
+        r.max_depth = q.stats.max_depth;
+    }
+    r.settle_ms = last_change > last_ms ? last_change - last_ms : 0;
+    r.final_state = state;
+    return r;
+}
+
+static void report(const char *mode, const result_t *r)
+{
+    printf("  %-5s %7u %7u %6u %7u %6u %6u %9u %9u %5u   S%u\n", mode, r->posted, r->dropped,
+           r->merged, r->applied, r->transitions, r->stale, r->max_age_ms, r->settle_ms,
+           r->max_depth, r->final_state);
+}
+
+static void run_scenario(const scenario_t *s, uint32_t seed)
+{
+    static press_t presses[MAX_PRESSES];
+    static event_list_t events;
+    char what[96];
+
+    rng = seed;
+    recognize(presses, s->gen(presses), &events);
+
+    printf("%s: %s, %zu events, last %s\n", s->name, s->desc, events.n,
+           events.n ? evt_names[events.e[events.n - 1].type] : "-");
+    if (events.n == 0) {
+        check(false, "the recognizer emitted no events");
+        return;
+    }
+    printf("  %-5s %7s %7s %6s %7s %6s %6s %9s %9s %5s %5s\n", "mode", "posted", "dropped",
+           "merged", "applied", "trans", "stale", "max age", "settle", "depth", "final");
+
+    result_t fifo = run(&events, false);
+    result_t evq = run(&events, true);
+    report("fifo", &fifo);
+    report("evq", &evq);
+
+    check(evq.dropped == 0, "evq dropped events");
+    check(evq.stale == 0, "evq applied stale events");
+    check(evq.max_depth <= EVQ_CAPACITY, "evq depth above EVQ_CAPACITY");
+    check(evq.last_age_ms <= state_delay_ms[0], "evq: the last event waited more than one loop");
+    if (s->final_state >= 0) {
+        snprintf(what, sizeof(what), "evq ended in S%u, expected S%d", evq.final_state,
+                 s->final_state);
+        check(evq.final_state == s->final_state, what);
+    }
+    printf("\n");
+}
+
+/* ===================== Queue contract ===================== */
+enum { T_PLAIN, T_COAL, T_HI, T_HI_PREEMPT, T_TOP, N_FUZZ };
+
+static const evq_policy_t fuzz_policy[N_FUZZ] = {
+    [T_PLAIN]      = { 0, 0 },
+    [T_COAL]       = { 0, EVQ_COALESCE },
+    [T_HI]         = { 1, 0 },
+    [T_HI_PREEMPT] = { 1, EVQ_COALESCE | EVQ_PREEMPT },
+    [T_TOP]        = { 2, EVQ_PREEMPT },
+};
+
+static uint8_t prio(uint8_t type)
+{
+    return fuzz_policy[type].prio;
+}
+
+/*
+ * One evq_post() against the documented policy. t_ms is a unique sequence
+ * number, so entries are matched by it. Returns the failure, or NULL.
+ */
+static const char *check_post(const evq_t *before, const evq_t *after, uint8_t type,
+                              uint32_t seq, bool ok)
+{
+    const evq_policy_t *p = &fuzz_policy[type];
+    unsigned coalesced = 0, preempted = 0, evicted = 0;
+    size_t kept = 0;
+
+    for (size_t i = 0; i < before->count; i++) {
+        const evq_entry_t *e = &before->entries[i];
+
+        if (kept < after->count && after->entries[kept].t_ms == e->t_ms) {
+            if ((p->flags & EVQ_PREEMPT) && prio(e->type) < p->prio) return "lower class survived a preempting event";
+            if ((p->flags & EVQ_COALESCE) && e->type == type) return "same type survived a coalescing event";
+            kept++;
+            continue;
+        }
+
+        /* removed: it must have been preempted, coalesced or evicted */
+        if ((p->flags & EVQ_PREEMPT) && prio(e->type) < p->prio) {
+            preempted++;
+        } else if ((p->flags & EVQ_COALESCE) && e->type == type && !coalesced) {
+            coalesced++;
+        } else if (!evicted && before->count == EVQ_CAPACITY && prio(e->type) <= p->prio) {
+            /* the victim is the oldest of the lowest class */
+            for (size_t j = 0; j < before->count; j++) {
+                uint8_t pj = prio(before->entries[j].type);
+                if (pj < prio(e->type) || (pj == prio(e->type) && j < i)) return "overflow evicted the wrong event";
+            }
+            evicted++;
+        } else {
+            return "event lost without being coalesced, preempted or evicted";
+        }
+    }
+    if (evicted && (coalesced || preempted)) return "overflow eviction with room in the queue";
+
+    if (!ok) {
+        if (before->count != EVQ_CAPACITY || coalesced || preempted || evicted) return "post refused with room in the queue";
+        for (size_t i = 0; i < before->count; i++) {
+            if (prio(before->entries[i].type) <= p->prio) return "post refused although it outranks a pending event";
+        }
+        return after->count == before->count ? NULL : "refused post changed the queue";
+    }
+
+    if (kept + 1 != after->count) return "post left extra entries";
+    if (after->entries[kept].type != type || after->entries[kept].t_ms != seq) return "new event not at the back";
+    return NULL;
+}
+
+static const char *check_take(const evq_t *before, const evq_t *after, const evq_entry_t *out,
+                              size_t n, size_t max)
+{
+    if (n != (before->count < max ? before->count : max)) return "take_all returned the wrong count";
+    for (size_t i = 0; i < n; i++) {
+        if (out[i].t_ms != before->entries[i].t_ms) return "take_all out of arrival order";
+    }
+    if (after->count != before->count - n) return "take_all left the wrong count";
+    for (size_t i = 0; i < after->count; i++) {
+        if (after->entries[i].t_ms != before->entries[n + i].t_ms) return "take_all reordered the rest";
+    }
+    return NULL;
+}
+
+static void run_contract(uint32_t seed)
+{
+    static const uint8_t type_mix[] = { T_PLAIN, T_PLAIN, T_PLAIN, T_COAL, T_COAL, T_HI, T_HI,
+                                        T_HI_PREEMPT, T_TOP };
+    evq_t q, before;
+    uint32_t seq = 0;
+    unsigned take_pct = 30;
+    const char *err = NULL;
+    char what[128];
+
+    rng = seed;
+    evq_init(&q, fuzz_policy, N_FUZZ);
+
+    for (uint32_t op = 0; op < FUZZ_OPS && !err; op++) {
+        /* phases that fill the queue, hover and drain it */
+        if (op % 64 == 0) take_pct = (unsigned[]){ 5, 30, 60 }[rnd(3)];
+        before = q;
+
+        if (rnd(100) < take_pct) {
+            evq_entry_t out[EVQ_CAPACITY];
+            size_t max = 1 + rnd(EVQ_CAPACITY);
+            size_t n = evq_take_all(&q, out, max);
+            err = check_take(&before, &q, out, n, max);
+        } else {
+            uint8_t type = type_mix[rnd(sizeof(type_mix))];
+            bool ok = evq_post(&q, type, ++seq);
+            err = check_post(&before, &q, type, seq, ok);
+        }
+
+        if (!err && (q.count > EVQ_CAPACITY || q.stats.max_depth > EVQ_CAPACITY)) err = "depth above EVQ_CAPACITY";
+        if (err) {
+            snprintf(what, sizeof(what), "contract, op %u: %s", op, err);
+        }
+    }
+
+    /* drain; then every posted event is accounted for exactly once */
+    evq_entry_t out[EVQ_CAPACITY];
+    while (!err && evq_take_all(&q, out, EVQ_CAPACITY)) {}
+    const evq_stats_t *st = &q.stats;
+    if (!err && st->posted != st->delivered + st->coalesced + st->preempted + st->overflow) {
+        snprintf(what, sizeof(what), "contract: posted %u != delivered %u + coalesced %u + preempted %u + overflow %u",
+                 st->posted, st->delivered, st->coalesced, st->preempted, st->overflow);
+        err = what;
+    }
+
+    printf("queue contract: %u ops, %u posted, %u delivered, %u coalesced, %u preempted, "
+           "%u overflow, max depth %u\n",
+           FUZZ_OPS, st->posted, st->delivered, st->coalesced, st->preempted, st->overflow,
+           st->max_depth);
+    check(st->overflow > 0 && st->preempted > 0 && st->coalesced > 0,
+          "contract: the random mix never hit overflow, preemption or coalescing");
+    check(err == NULL, err ? what : "");
+    printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t seed = 1;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--seed")) {
+            seed = strtoul(argv[i + 1], NULL, 0);
+        } else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    run_contract(seed);
+    for (size_t s = 0; s < sizeof(scenarios) / sizeof(scenarios[0]); s++) {
+        run_scenario(&scenarios[s], seed);
+    }
+
+    printf("%s: %u failed check%s\n", failures ? "FAIL" : "PASS", failures,
+           failures == 1 ? "" : "s");
+    return failures ? 1 : 0;
+}
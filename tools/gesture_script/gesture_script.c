@@ -0,0 +1,310 @@
+/*
+ * lab1 gesture recognizer (lab1/gesture.c) against scripted edge sequences.
+ *
+ *   gesture_script [SCRIPT...]
+ *
+ * With no arguments, runs the built-in scenarios and checks each one's
+ * gestures against the expected list (exit status 1 on any mismatch),
+ * then times gesture_edge() over a random edge storm. With SCRIPT files,
+ * replays each and prints the gestures. Script lines:
+ *
+ *   <t_ms> <b1|b2|b3> <down|up>      # comment
+ *
+ * Buttons, flags and timing match lab1.c. Time is virtual: edges and
+ * recognizer deadlines run in time order, edges first on a tie, the way
+ * the GPIO and alarm IRQs would. "late" scenarios hold the deadlines
+ * back until after the last edge, as if the alarm IRQ were delayed: the
+ * edges must still see the timeouts that passed before them. "wakeups"
+ * counts deadline expiries, next to the ticks a 10 ms polling loop would
+ * have spent on the same span.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "gesture.h"
+
+#define MAX_EDGES   256
+#define MAX_OUT     2048
+#define POLL_MS     10
+#define STORM_EDGES 1000000
+
+/* ===================== lab1 configuration (copy of lab1.c) ===================== */
+static const uint8_t lab1_flags[] = {
+    GESTURE_LONG | GESTURE_DOUBLE | GESTURE_CHORD,  // b1
+    GESTURE_LONG | GESTURE_CHORD,                   // b2
+    0,                                              // b3
+};
+
+static const gesture_timing_t lab1_timing = { 50000, 600000, 250000, 80000 };
+
+/* ===================== Scripts ===================== */
+typedef struct {
+    uint32_t t_ms;
+    uint8_t button;
+    bool pressed;
+} edge_t;
+
+typedef struct {
+    const char *name;
+    const char *script;
+    const char *expect;     // one "<t_ms> <kind> <buttons>" line per gesture
+    bool late;              // deadlines run only after the last edge
+} scenario_t;
+
+static const scenario_t scenarios[] = {
+    { .name = "click b2",
+      .script = "100 b2 down\n200 b2 up\n",
+      .expect = "200 click b2\n" },
+    { .name = "click b1",
+      .script = "100 b1 down\n180 b1 up\n",
+      .expect = "430 click b1\n" },  // after the double-click window
+    { .name = "press b3",
+      .script = "100 b3 down\n150 b3 up\n",
+      .expect = "100 press b3\n" },
+    { .name = "double b1",
+      .script = "100 b1 down\n180 b1 up\n300 b1 down\n380 b1 up\n",
+      .expect = "300 double b1\n" },
+    { .name = "two clicks b1",
+      .script = "100 b1 down\n200 b1 up\n500 b1 down\n560 b1 up\n",
+      .expect = "450 click b1\n810 click b1\n" },
+    { .name = "long b1",
+      .script = "100 b1 down\n1000 b1 up\n",
+      .expect = "700 long b1\n" },
+    { .name = "long b2",
+      .script = "100 b2 down\n900 b2 up\n",
+      .expect = "700 long b2\n" },
+    { .name = "chord",
+      .script = "100 b1 down\n140 b2 down\n400 b2 up\n420 b1 up\n",
+      .expect = "140 chord b1+b2\n" },
+    { .name = "held chord",
+      .script = "100 b2 down\n150 b1 down\n2000 b1 up\n2000 b2 up\n",
+      .expect = "150 chord b1+b2\n" },  // no long-press after a chord
+    { .name = "not a chord",
+      .script = "100 b1 down\n300 b2 down\n350 b2 up\n400 b1 up\n",
+      .expect = "350 click b2\n650 click b1\n" },
+    { .name = "bouncy click",
+      .script = "100 b1 down\n103 b1 up\n106 b1 down\n110 b1 up\n112 b1 down\n"
+                "300 b1 up\n303 b1 down\n306 b1 up\n",
+      .expect = "550 click b1\n" },
+    { .name = "tap in lockout",
+      .script = "100 b2 down\n130 b2 up\n",
+      .expect = "150 click b2\n" },  // release taken when the lockout ends
+    { .name = "b3 during long",
+      .script = "100 b1 down\n300 b3 down\n350 b3 up\n900 b1 up\n",
+      .expect = "300 press b3\n700 long b1\n" },
+    { .name = "late 2nd press",
+      .script = "100 b1 down\n180 b1 up\n500 b1 down\n560 b1 up\n",
+      .expect = "430 click b1\n810 click b1\n", .late = true },  // not a double
+    { .name = "late release",
+      .script = "100 b1 down\n1000 b1 up\n",
+      .expect = "700 long b1\n", .late = true },  // not a click
+    { .name = "late lockout",
+      .script = "100 b2 down\n130 b2 up\n300 b2 down\n400 b2 up\n",
+      .expect = "150 click b2\n400 click b2\n", .late = true },
+    { .name = "late other btn",
+      .script = "100 b1 down\n180 b1 up\n500 b2 down\n560 b2 up\n",
+      .expect = "430 click b1\n560 click b2\n", .late = true },  // in time order
+};
+
+static const char *const kind_names[] = {
+    [GESTURE_PRESS] = "press",
+    [GESTURE_CLICK] = "click",
+    [GESTURE_DOUBLE_CLICK] = "double",
+    [GESTURE_LONG_PRESS] = "long",
+    [GESTURE_CHORD_PRESS] = "chord",
+};
+
+static size_t parse(const char *text, edge_t *edges)
+{
+    size_t n = 0;
+    const char *line = text;
+
+    while (*line && n < MAX_EDGES) {
+        unsigned t, b;
+        char dir[8];
+
+        if (sscanf(line, "%u b%u %7s", &t, &b, dir) == 3 && b >= 1 && b <= 3) {
+            edges[n].t_ms = t;
+            edges[n].button = (uint8_t)(b - 1);
+            edges[n].pressed = !strcmp(dir, "down");
+            n++;
+        } else if (line[strspn(line, " \t")] != '#' && line[strspn(line, " \t")] != '\n') {
+            fprintf(stderr, "bad script line: %.*s\n", (int)strcspn(line, "\n"), line);
+        }
+
+        line += strcspn(line, "\n");
+        if (*line) line++;
+    }
+    return n;
+}
+
+/* ===================== Virtual-time run ===================== */
+typedef struct {
+    char text[MAX_OUT];
+    size_t len;
+} output_t;
+
+static void collect(void *ctx, gesture_kind_t kind, uint8_t buttons, uint32_t t_us)
+{
+    output_t *out = ctx;
+    char names[16] = "";
+
+    for (int i = 0; i < 3; i++) {
+        if (!(buttons & (1u << i))) continue;
+        size_t l = strlen(names);
+        snprintf(names + l, sizeof(names) - l, "%sb%d", l ? "+" : "", i + 1);
+    }
+    out->len += (size_t)snprintf(out->text + out->len, sizeof(out->text) - out->len,
+                                 "%u %s %s\n", t_us / 1000, kind_names[kind], names);
+}
+
+static void run(gesture_t *g, const edge_t *edges, size_t n, bool late)
+{
+    size_t next = 0;
+    uint32_t t;
+
+    for (;;) {
+        bool pending = gesture_next_deadline(g, &t);
+
+        if (next < n && (!pending || late || edges[next].t_ms * 1000u <= t)) {
+            gesture_edge(g, edges[next].button, edges[next].pressed, edges[next].t_ms * 1000u);
+            next++;
+        } else if (pending) {
+            gesture_expire(g, t);
+        } else {
+            break;
+        }
+    }
+}
+
+static bool run_scenario(const scenario_t *s)
+{
+    static edge_t edges[MAX_EDGES];
+    gesture_t g;
+    output_t out = { .len = 0 };
+
+    size_t n = parse(s->script, edges);
+    gesture_init(&g, lab1_flags, sizeof(lab1_flags), &lab1_timing, collect, &out);
+    run(&g, edges, n, s->late);
+
+    bool ok = !strcmp(out.text, s->expect);
+    uint32_t span_ms = n ? edges[n - 1].t_ms : 0;
+
+    printf("  %-15s %5u %6u %7u %7u   %s\n", s->name, g.stats.edges, g.stats.bounces,
+           g.stats.wakeups, span_ms / POLL_MS, ok ? "PASS" : "FAIL");
+    if (!ok) {
+        printf("    expected:\n%s    got:\n%s", s->expect, out.text);
+    }
+    return ok;
+}
+
+static int run_file(const char *path)
+{
+    static char text[65536];
+    static edge_t edges[MAX_EDGES];
+    FILE *f = fopen(path, "r");
+
+    if (!f) {
+        perror(path);
+        return 2;
+    }
+    size_t len = fread(text, 1, sizeof(text) - 1, f);
+    text[len] = '\0';
+    fclose(f);
+
+    gesture_t g;
+    output_t out = { .len = 0 };
+    size_t n = parse(text, edges);
+
+    gesture_init(&g, lab1_flags, sizeof(lab1_flags), &lab1_timing, collect, &out);
+    run(&g, edges, n, false);
+
+    printf("%s: %u edges, %u bounces, %u wakeups\n%s", path, g.stats.edges, g.stats.bounces,
+           g.stats.wakeups, out.text);
+    return 0;
+}
+
+/* ===================== Cost per edge ===================== */
+static uint32_t rng = 1;
+static uint32_t rnd(uint32_t n)
+{
+    rng = rng * 1664525u + 1013904223u;
+    return (rng >> 8) % n;
+}
+
+static void discard(void *ctx, gesture_kind_t kind, uint8_t buttons, uint32_t t_us)
+{
+    (void)kind; (void)buttons; (void)t_us;
+    (*(uint32_t *)ctx)++;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* edge plus the deadline re-arm the ISR does after it, as one unit */
+static void storm(uint8_t n_buttons)
+{
+    static uint8_t flags[GESTURE_MAX_BUTTONS];
+    gesture_t g;
+    uint32_t emitted = 0, t_us = 0, deadline;
+    bool level[GESTURE_MAX_BUTTONS] = { false };
+    uint64_t total = 0;
+
+    for (uint8_t i = 0; i < n_buttons; i++) {
+        flags[i] = GESTURE_LONG | GESTURE_DOUBLE | GESTURE_CHORD;
+    }
+    gesture_init(&g, flags, n_buttons, &lab1_timing, discard, &emitted);
+
+    for (uint32_t i = 0; i < STORM_EDGES; i++) {
+        uint8_t b = (uint8_t)rnd(n_buttons);
+        t_us += 1 + rnd(120000);
+        level[b] = !level[b];
+
+        while (gesture_next_deadline(&g, &deadline) && (int32_t)(t_us - deadline) >= 0) {
+            gesture_expire(&g, deadline);
+        }
+
+        uint64_t t0 = now_ns();
+        gesture_edge(&g, b, level[b], t_us);
+        (void)gesture_next_deadline(&g, &deadline);
+        total += now_ns() - t0;
+    }
+
+    printf("  %u buttons: %u edges, %u gestures, %u wakeups, %.1f ns/edge (incl. clock read)\n",
+           n_buttons, g.stats.edges, emitted, g.stats.wakeups, (double)total / STORM_EDGES);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1) {
+        int rc = 0;
+        for (int i = 1; i < argc; i++) {
+            if (run_file(argv[i])) rc = 2;
+        }
+        return rc;
+    }
+
+    unsigned failed = 0;
+
+    printf("scenarios (lab1 flags and timing)\n");
+    printf("  %-15s %5s %6s %7s %7s\n", "name", "edges", "bounce", "wakeups", "polls");
+    for (size_t s = 0; s < sizeof(scenarios) / sizeof(scenarios[0]); s++) {
+        if (!run_scenario(&scenarios[s])) failed++;
+    }
+
+    printf("\nrandom edge storm\n");
+    storm(3);
+    storm(GESTURE_MAX_BUTTONS);
+
+    printf("\n%u of %zu scenarios failed\n", failed, sizeof(scenarios) / sizeof(scenarios[0]));
+    return failed ? 1 : 0;
+}
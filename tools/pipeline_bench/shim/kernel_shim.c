@@ -0,0 +1,180 @@
+/*
+ * pthread implementations of the kernel objects in shim/zephyr/kernel.h.
+ *
+ * Every thread runs on CPU 0, like the single core the lab3 apps use,
+ * and a Zephyr priority p becomes nice p - 4 relative to main(), so the
+ * acquisition thread (4) gets the CPU ahead of the output thread (7).
+ */
+
+#define _GNU_SOURCE
+#include <sched.h>
+#include <stdio.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <zephyr/kernel.h>
+
+#define MAIN_PRIO 4
+
+/* ===================== Time ===================== */
+static int64_t mono_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int64_t boot_us;
+
+int64_t shim_now_us(void)
+{
+    return mono_us() - boot_us;
+}
+
+void k_busy_wait(uint32_t us)
+{
+    int64_t end = mono_us() + us;
+
+    while (mono_us() < end) {
+    }
+}
+
+static void sleep_until(int64_t t_us)
+{
+    struct timespec ts = { (time_t)((boot_us + t_us) / 1000000),
+                           (long)((boot_us + t_us) % 1000000) * 1000 };
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+}
+
+/* an absolute timeout already past returns at once, as in Zephyr */
+int32_t k_sleep(k_timeout_t t)
+{
+    sleep_until(t.abs_us >= 0 ? t.abs_us : shim_now_us() + t.rel_us);
+    return 0;
+}
+
+int32_t k_usleep(int32_t us)
+{
+    return k_sleep((k_timeout_t){ -1, us });
+}
+
+int32_t k_msleep(int32_t ms)
+{
+    return k_sleep((k_timeout_t){ -1, (int64_t)ms * 1000 });
+}
+
+/* ===================== Spinlock ===================== */
+k_spinlock_key_t k_spin_lock(struct k_spinlock *l)
+{
+    pthread_mutex_lock(&l->m);
+    return 0;
+}
+
+void k_spin_unlock(struct k_spinlock *l, k_spinlock_key_t key)
+{
+    ARG_UNUSED(key);
+    pthread_mutex_unlock(&l->m);
+}
+
+/* ===================== FIFO ===================== */
+void k_fifo_put(struct k_fifo *fifo, void *data)
+{
+    pthread_mutex_lock(&fifo->m);
+    *(void **)data = NULL;
+    if (fifo->tail) {
+        *(void **)fifo->tail = data;
+    } else {
+        fifo->head = data;
+    }
+    fifo->tail = data;
+    pthread_cond_signal(&fifo->c);
+    pthread_mutex_unlock(&fifo->m);
+}
+
+/* K_FOREVER or K_NO_WAIT only */
+void *k_fifo_get(struct k_fifo *fifo, k_timeout_t timeout)
+{
+    void *data;
+
+    pthread_mutex_lock(&fifo->m);
+    while (!fifo->head && timeout.rel_us != 0) {
+        pthread_cond_wait(&fifo->c, &fifo->m);
+    }
+    data = fifo->head;
+    if (data) {
+        fifo->head = *(void **)data;
+        if (!fifo->head) fifo->tail = NULL;
+    }
+    pthread_mutex_unlock(&fifo->m);
+    return data;
+}
+
+/* ===================== Memory slab ===================== */
+/* K_NO_WAIT only: -ENOMEM when the slab is empty */
+int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, k_timeout_t timeout)
+{
+    int rc = -ENOMEM;
+
+    ARG_UNUSED(timeout);
+    pthread_mutex_lock(&slab->m);
+    if (!slab->free_list && slab->carved < slab->num_blocks) {
+        slab->free_list = slab->buffer + slab->carved++ * slab->block_size;
+        *(void **)slab->free_list = NULL;
+    }
+    if (slab->free_list) {
+        *mem = slab->free_list;
+        slab->free_list = *(void **)slab->free_list;
+        rc = 0;
+    }
+    pthread_mutex_unlock(&slab->m);
+    return rc;
+}
+
+void k_mem_slab_free(struct k_mem_slab *slab, void *mem)
+{
+    pthread_mutex_lock(&slab->m);
+    *(void **)mem = slab->free_list;
+    slab->free_list = mem;
+    pthread_mutex_unlock(&slab->m);
+}
+
+/* ===================== Threads ===================== */
+static void set_nice(int prio)
+{
+    /* raising nice needs no privileges; main() sits at MAIN_PRIO */
+    setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), prio - MAIN_PRIO);
+}
+
+static void *thread_main(void *arg)
+{
+    k_tid_t t = arg;
+
+    set_nice(t->prio);
+    t->entry(NULL, NULL, NULL);
+    return NULL;
+}
+
+void k_thread_start(k_tid_t thread)
+{
+    if (pthread_create(&thread->pt, NULL, thread_main, thread) != 0) {
+        perror("pthread_create");
+    }
+}
+
+__attribute__((constructor)) static void shim_init(void)
+{
+    cpu_set_t cpu;
+
+    CPU_ZERO(&cpu);
+    CPU_SET(0, &cpu);
+    if (sched_setaffinity(0, sizeof(cpu), &cpu) != 0) {
+        perror("sched_setaffinity");
+    }
+    boot_us = mono_us();
+    setvbuf(stdout, NULL, _IOLBF, 0);
+}
@@ -0,0 +1,108 @@
+#ifndef PIPELINE_BENCH_SHIM_ZEPHYR_KERNEL_H
+#define PIPELINE_BENCH_SHIM_ZEPHYR_KERNEL_H
+
+/*
+ * Host stand-in for the Zephyr kernel objects sensor_pipeline.c and the
+ * lab3/pipeline_bench app use, on pthreads and the real monotonic clock
+ * (1 tick = 1 cycle = 1 us). Threads are pinned to one CPU and niced by
+ * their Zephyr priority (see kernel_shim.c), so the stages compete for a
+ * single core as on the board; the host scheduler is fair share, not
+ * strict priority.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <zephyr/toolchain.h>
+
+#define ARG_UNUSED(x)   (void)(x)
+#define SYS_FOREVER_MS  (-1)
+
+/* ===================== Time ===================== */
+int64_t shim_now_us(void);
+
+typedef struct {
+    int64_t abs_us;     // absolute deadline, or -1
+    int64_t rel_us;     // relative wait; -1 = forever
+} k_timeout_t;
+
+#define K_NO_WAIT               ((k_timeout_t){ -1, 0 })
+#define K_FOREVER               ((k_timeout_t){ -1, -1 })
+#define K_SECONDS(s)            ((k_timeout_t){ -1, (int64_t)(s) * 1000000 })
+#define K_TIMEOUT_ABS_TICKS(t)  ((k_timeout_t){ (int64_t)(t), 0 })
+
+static inline int64_t k_uptime_ticks(void)                  { return shim_now_us(); }
+static inline int64_t k_uptime_get(void)                    { return shim_now_us() / 1000; }
+static inline uint32_t k_uptime_get_32(void)                { return (uint32_t)k_uptime_get(); }
+static inline uint32_t k_cycle_get_32(void)                 { return (uint32_t)shim_now_us(); }
+static inline uint32_t k_cyc_to_us_floor32(uint32_t cyc)    { return cyc; }
+static inline uint64_t k_ticks_to_us_floor64(uint64_t t)    { return t; }
+static inline int64_t k_ms_to_ticks_ceil64(uint32_t ms)     { return (int64_t)ms * 1000; }
+
+void k_busy_wait(uint32_t us);
+int32_t k_sleep(k_timeout_t t);
+int32_t k_usleep(int32_t us);
+int32_t k_msleep(int32_t ms);
+
+/* ===================== Spinlock ===================== */
+struct k_spinlock {
+    pthread_mutex_t m;
+};
+
+typedef int k_spinlock_key_t;
+
+k_spinlock_key_t k_spin_lock(struct k_spinlock *l);
+void k_spin_unlock(struct k_spinlock *l, k_spinlock_key_t key);
+
+/* ===================== FIFO ===================== */
+/* items start with a reserved pointer, as in Zephyr */
+struct k_fifo {
+    pthread_mutex_t m;
+    pthread_cond_t c;
+    void *head;
+    void *tail;
+};
+
+#define K_FIFO_DEFINE(name) \
+    struct k_fifo name = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, NULL, NULL }
+
+void k_fifo_put(struct k_fifo *fifo, void *data);
+void *k_fifo_get(struct k_fifo *fifo, k_timeout_t timeout);
+
+/* ===================== Memory slab ===================== */
+struct k_mem_slab {
+    pthread_mutex_t m;
+    char *buffer;
+    size_t block_size;
+    uint32_t num_blocks;
+    void *free_list;
+    uint32_t carved;    // blocks handed to free_list so far
+};
+
+#define K_MEM_SLAB_DEFINE_STATIC(name, size, num, align)                                   \
+    static char name##_buf[(num) * ROUND_UP(size, align)] __aligned(align);               \
+    static struct k_mem_slab name = { PTHREAD_MUTEX_INITIALIZER, name##_buf,               \
+                                      ROUND_UP(size, align), (num), NULL, 0 }
+
+int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, k_timeout_t timeout);
+void k_mem_slab_free(struct k_mem_slab *slab, void *mem);
+
+/* ===================== Threads ===================== */
+struct shim_thread {
+    void (*entry)(void *, void *, void *);
+    int prio;
+    pthread_t pt;
+};
+
+typedef struct shim_thread *k_tid_t;
+
+/* only the delay = SYS_FOREVER_MS form: started by k_thread_start() */
+#define K_THREAD_DEFINE(name, stack, fn, p1, p2, p3, pr, options, delay)          \
+    static struct shim_thread name##_thread = { .entry = (fn), .prio = (pr) };      \
+    static const k_tid_t name = &name##_thread
+
+void k_thread_start(k_tid_t thread);
+
+#endif /* PIPELINE_BENCH_SHIM_ZEPHYR_KERNEL_H */
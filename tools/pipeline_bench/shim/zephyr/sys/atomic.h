@@ -0,0 +1,15 @@
+#ifndef PIPELINE_BENCH_SHIM_ZEPHYR_SYS_ATOMIC_H
+#define PIPELINE_BENCH_SHIM_ZEPHYR_SYS_ATOMIC_H
+
+#include <stdatomic.h>
+
+typedef long atomic_val_t;
+typedef _Atomic long atomic_t;
+
+/* like Zephyr, inc/dec return the previous value */
+static inline atomic_val_t atomic_inc(atomic_t *a)              { return atomic_fetch_add(a, 1); }
+static inline atomic_val_t atomic_dec(atomic_t *a)              { return atomic_fetch_sub(a, 1); }
+static inline atomic_val_t atomic_get(const atomic_t *a)        { return atomic_load(a); }
+static inline atomic_val_t atomic_set(atomic_t *a, atomic_val_t v) { return atomic_exchange(a, v); }
+
+#endif /* PIPELINE_BENCH_SHIM_ZEPHYR_SYS_ATOMIC_H */
@@ -0,0 +1,8 @@
+#ifndef PIPELINE_BENCH_SHIM_ZEPHYR_SYS_PRINTK_H
+#define PIPELINE_BENCH_SHIM_ZEPHYR_SYS_PRINTK_H
+
+#include <stdio.h>
+
+#define printk printf
+
+#endif /* PIPELINE_BENCH_SHIM_ZEPHYR_SYS_PRINTK_H */
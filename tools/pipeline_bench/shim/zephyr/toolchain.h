@@ -0,0 +1,8 @@
+#ifndef PIPELINE_BENCH_SHIM_ZEPHYR_TOOLCHAIN_H
+#define PIPELINE_BENCH_SHIM_ZEPHYR_TOOLCHAIN_H
+
+#define BUILD_ASSERT(cond, msg) _Static_assert(cond, msg)
+#define __aligned(x)            __attribute__((aligned(x)))
+#define ROUND_UP(x, align)      ((((x) + (align) - 1) / (align)) * (align))
+
+#endif /* PIPELINE_BENCH_SHIM_ZEPHYR_TOOLCHAIN_H */
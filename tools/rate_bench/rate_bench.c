@@ -0,0 +1,231 @@
+/*
+ * Adaptive vs fixed-rate sampling benchmark.
+ *
+ *   rate_bench [--csv FILE] [--hours H] [--fixed-ms N] [--min-ms N]
+ *              [--max-ms N] [--tol N] [--txn N]
+ *
+ * Runs lab3/common/adaptive_rate.c against a set of emulated temperature
+ * profiles (or a recorded one: CSV lines "t_ms,value" with value in
+ * 0.01 C, e.g. read back from the sample log) and against the labs'
+ * fixed 3 s loop. For each it reports
+ *   - I2C transactions per hour (samples/h * --txn; 2 for the raw
+ *     lab3/part1 path: one ctrl_meas write + one burst read)
+ *   - reconstruction error: the sampled series, linearly interpolated,
+ *     against the true signal at 100 ms resolution (RMS and max).
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "adaptive_rate.h"
+
+#define STEP_MS 100
+
+/* ===================== Profiles ===================== */
+typedef double (*profile_fn)(double t_s);
+
+static double prof_flat(double t)  { (void)t; return 2250; }
+static double prof_ramp(double t)  { return 2000 + t * 50.0 / 60.0; }   // 0.5 C/min
+static double prof_daily(double t) { return 2250 + 500 * sin(2 * M_PI * t / 7200); }
+
+/* flat, then a door opens: 4 C drop with a 60 s time constant, recovery after 20 min */
+static double prof_step(double t)
+{
+    double v = 2250;
+    double t_open = 1800, t_close = 3000;
+    if (t > t_open)  v -= 400 * (1 - exp(-(t - t_open) / 60));
+    if (t > t_close) v += 400 * (1 - exp(-(t - t_close) / 300));
+    return v;
+}
+
+static const struct {
+    const char *name;
+    profile_fn fn;
+} profiles[] = {
+    { "flat",  prof_flat },
+    { "ramp",  prof_ramp },
+    { "step",  prof_step },
+    { "daily", prof_daily },
+};
+
+/* recorded profile, linearly interpolated */
+static double *rec_t, *rec_v;
+static size_t rec_n;
+
+static double prof_recorded(double t)
+{
+    double t_ms = t * 1000;
+    if (t_ms <= rec_t[0]) return rec_v[0];
+    for (size_t i = 1; i < rec_n; i++) {
+        if (t_ms <= rec_t[i]) {
+            double a = (t_ms - rec_t[i - 1]) / (rec_t[i] - rec_t[i - 1]);
+            return rec_v[i - 1] + a * (rec_v[i] - rec_v[i - 1]);
+        }
+    }
+    return rec_v[rec_n - 1];
+}
+
+static int load_csv(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+
+    size_t cap = 1024;
+    rec_t = malloc(cap * sizeof(double));
+    rec_v = malloc(cap * sizeof(double));
+
+    double t, v;
+    while (fscanf(f, "%lf,%lf", &t, &v) == 2) {
+        if (rec_n == cap) {
+            cap *= 2;
+            rec_t = realloc(rec_t, cap * sizeof(double));
+            rec_v = realloc(rec_v, cap * sizeof(double));
+        }
+        rec_t[rec_n] = t;
+        rec_v[rec_n] = v;
+        rec_n++;
+    }
+    fclose(f);
+
+    /* start the record at t = 0 */
+    for (size_t i = 1; i < rec_n; i++) rec_t[i] -= rec_t[0];
+    if (rec_n) rec_t[0] = 0;
+    return rec_n >= 2 ? 0 : -1;
+}
+
+/* ===================== Simulation ===================== */
+/* sensor noise: +-0.03 C, deterministic per run */
+static uint32_t rng;
+static int32_t noise(void)
+{
+    rng = rng * 1664525u + 1013904223u;
+    return (int32_t)(rng >> 29) - 3;
+}
+
+struct result {
+    uint32_t samples;
+    double rms;
+    double max;
+    uint32_t max_gap_ms;
+};
+
+/* sample the profile, either at a fixed rate or through the controller */
+static struct result run(profile_fn fn, uint32_t dur_ms, uint32_t fixed_ms,
+                         const struct adaptive_rate_cfg *cfg)
+{
+    struct adaptive_rate ar;
+    if (cfg) adaptive_rate_init(&ar, cfg);
+
+    size_t cap = 1024, n = 0;
+    uint32_t *st = malloc(cap * sizeof(*st));
+    int32_t *sv = malloc(cap * sizeof(*sv));
+
+    rng = 12345;
+    for (uint32_t t = 0; t <= dur_ms;) {
+        int32_t v = (int32_t)lround(fn(t / 1000.0)) + noise();
+        if (n == cap) {
+            cap *= 2;
+            st = realloc(st, cap * sizeof(*st));
+            sv = realloc(sv, cap * sizeof(*sv));
+        }
+        st[n] = t;
+        sv[n] = v;
+        n++;
+
+        t += cfg ? adaptive_rate_update(&ar, t, v) : fixed_ms;
+    }
+
+    struct result r = { .samples = (uint32_t)n };
+    double sq = 0;
+    size_t k = 0, pts = 0;
+
+    for (uint32_t t = 0; t <= st[n - 1]; t += STEP_MS) {
+        while (k + 1 < n && st[k + 1] <= t) k++;
+        double est = sv[k];
+        if (k + 1 < n) {
+            double a = (double)(t - st[k]) / (st[k + 1] - st[k]);
+            est += a * (sv[k + 1] - sv[k]);
+        }
+        double err = fabs(est - fn(t / 1000.0));
+        sq += err * err;
+        if (err > r.max) r.max = err;
+        pts++;
+    }
+    r.rms = sqrt(sq / pts);
+
+    for (size_t i = 1; i < n; i++) {
+        if (st[i] - st[i - 1] > r.max_gap_ms) r.max_gap_ms = st[i] - st[i - 1];
+    }
+
+    free(st);
+    free(sv);
+    return r;
+}
+
+static void report(const char *name, const char *mode, const struct result *r,
+                   uint32_t dur_ms, uint32_t txn)
+{
+    double hours = dur_ms / 3600000.0;
+    printf("%-9s %-9s %9.0f %10.0f %9.3f %9.3f %9.1f\n", name, mode,
+           r->samples / hours, r->samples * txn / hours,
+           r->rms / 100, r->max / 100, r->max_gap_ms / 1000.0);
+}
+
+int main(int argc, char **argv)
+{
+    const char *csv = NULL;
+    double hours = 6;
+    uint32_t fixed_ms = 3000, txn = 2;
+    struct adaptive_rate_cfg cfg = {
+        .min_interval_ms = 1000,
+        .max_interval_ms = 30000,
+        .tolerance = 5,
+    };
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--csv"))           csv = argv[i + 1];
+        else if (!strcmp(argv[i], "--hours"))    hours = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--fixed-ms")) fixed_ms = strtoul(argv[i + 1], NULL, 0);
+        else if (!strcmp(argv[i], "--min-ms"))   cfg.min_interval_ms = strtoul(argv[i + 1], NULL, 0);
+        else if (!strcmp(argv[i], "--max-ms"))   cfg.max_interval_ms = strtoul(argv[i + 1], NULL, 0);
+        else if (!strcmp(argv[i], "--tol"))      cfg.tolerance = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--txn"))      txn = strtoul(argv[i + 1], NULL, 0);
+        else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    uint32_t dur_ms = (uint32_t)(hours * 3600000);
+    if (csv) {
+        if (load_csv(csv) != 0) {
+            fprintf(stderr, "%s: need at least two \"t_ms,value\" lines\n", csv);
+            return 2;
+        }
+        dur_ms = (uint32_t)rec_t[rec_n - 1];
+    }
+
+    printf("adaptive: %u..%u ms, tolerance %d.%02d C; fixed: %u ms; %u I2C txn/sample\n\n",
+           cfg.min_interval_ms, cfg.max_interval_ms, cfg.tolerance / 100, cfg.tolerance % 100,
+           fixed_ms, txn);
+    printf("%-9s %-9s %9s %10s %9s %9s %9s\n",
+           "profile", "mode", "samples/h", "i2c txn/h", "rms [C]", "max [C]", "gap [s]");
+
+    if (csv) {
+        struct result f = run(prof_recorded, dur_ms, fixed_ms, NULL);
+        struct result a = run(prof_recorded, dur_ms, 0, &cfg);
+        report("recorded", "fixed", &f, dur_ms, txn);
+        report("recorded", "adaptive", &a, dur_ms, txn);
+        return 0;
+    }
+
+    for (size_t i = 0; i < sizeof(profiles) / sizeof(profiles[0]); i++) {
+        struct result f = run(profiles[i].fn, dur_ms, fixed_ms, NULL);
+        struct result a = run(profiles[i].fn, dur_ms, 0, &cfg);
+        report(profiles[i].name, "fixed", &f, dur_ms, txn);
+        report(profiles[i].name, "adaptive", &a, dur_ms, txn);
+    }
+    return 0;
+}
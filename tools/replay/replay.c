@@ -0,0 +1,389 @@
+/*
+ * Host replay driver.
+ *
+ *   replay_<target> TRACE [--golden FILE] [--record FILE] [--tail-ms N]
+ *
+ * TRACE   binary input trace (common/input_trace.h), e.g. captured with
+ *         LAB1_TRACE_CAPTURE or CONFIG_APP_INPUT_TRACE
+ * golden  compare every output frame against a previous recording
+ * record  write the output frames of this run as a new golden trace
+ * tail-ms keep running this long after the last record (default 1000)
+ *
+ * Device check: a LAB1_TRACE_CAPTURE trace also carries the device's
+ * output frame of every main-loop pass. The replay then paces each loop
+ * pass to the device's (replay_pace_us) and compares every frame's LED
+ * state with the device's; this is what catches host/device divergence.
+ * The lab2/part2 capture records edges only, so its replays go unchecked.
+ *
+ * Golden files are recorded by this tool, not on the device: they only
+ * catch regressions between two host runs.
+ *
+ * Exit status: 0 on success / match, 1 on a device or golden mismatch,
+ * 2 on usage or I/O errors, 3 on mismatch when the capture itself lost
+ * edges (its drop markers say so), where the divergence may be the
+ * capture's, not the target's.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "input_trace.h"
+#include "replay.h"
+
+#define GOLDEN_HEADER_LEN 8
+#define GOLDEN_FRAME_LEN  11   // t_us (8) + leds (1) + pwm (2), little endian
+
+typedef struct {
+    uint64_t t_us;
+    uint8_t  leds;
+    uint16_t pwm;
+    uint8_t  outputs;   // as the device encodes them
+} frame_t;
+
+/* one output frame recorded on the device */
+typedef struct {
+    uint64_t t_us;
+    uint8_t  outputs;
+} device_frame_t;
+
+/* ===================== Replay state ===================== */
+static struct input_edge *edges;
+static size_t edge_count;
+static size_t edge_next;
+static uint64_t edges_lost;
+static uint64_t first_loss_us = UINT64_MAX;
+
+static uint64_t now_us;
+static uint64_t end_us;
+
+static frame_t *frames;
+static size_t frame_count;
+static size_t frame_cap;
+
+static device_frame_t *device;
+static size_t device_count;
+static size_t device_mismatch_count;
+static size_t device_first_mismatch = SIZE_MAX;
+
+static const frame_t *golden;
+static size_t golden_count;
+static size_t mismatch_count;
+static size_t first_mismatch = SIZE_MAX;
+
+static jmp_buf done_jmp;
+
+/* ===================== Virtual clock ===================== */
+uint64_t replay_now_us(void)
+{
+    return now_us;
+}
+
+uint64_t replay_next_edge_us(void)
+{
+    return edge_next < edge_count ? edges[edge_next].t_us : UINT64_MAX;
+}
+
+bool replay_advance_to(uint64_t t_us)
+{
+    if (t_us > end_us) {
+        now_us = end_us;
+        return false;
+    }
+
+    while (edge_next < edge_count && edges[edge_next].t_us <= t_us) {
+        const struct input_edge *e = &edges[edge_next++];
+        now_us = e->t_us;
+        replay_target_edge(e->pin, e->rising);
+    }
+
+    if (t_us > now_us) now_us = t_us;
+    return true;
+}
+
+uint64_t replay_pace_us(uint64_t t_us)
+{
+    /* frame_count is the index of the frame the sleep leads up to */
+    if (frame_count < device_count && device[frame_count].t_us > now_us) {
+        return device[frame_count].t_us;
+    }
+    return t_us;
+}
+
+void replay_frame(void)
+{
+    frame_t f = { now_us, replay_target_leds(), replay_target_pwm(), replay_target_outputs() };
+
+    if (frame_count == frame_cap) {
+        frame_cap = frame_cap ? frame_cap * 2 : 1024;
+        frames = realloc(frames, frame_cap * sizeof(*frames));
+        if (!frames) {
+            fprintf(stderr, "out of memory\n");
+            exit(2);
+        }
+    }
+
+    if (golden) {
+        const frame_t *g = frame_count < golden_count ? &golden[frame_count] : NULL;
+        if (!g || g->t_us != f.t_us || g->leds != f.leds || g->pwm != f.pwm) {
+            if (first_mismatch == SIZE_MAX) first_mismatch = frame_count;
+            mismatch_count++;
+        }
+    }
+
+    if (frame_count < device_count && device[frame_count].outputs != f.outputs) {
+        if (device_first_mismatch == SIZE_MAX) device_first_mismatch = frame_count;
+        device_mismatch_count++;
+    }
+
+    frames[frame_count++] = f;
+}
+
+void replay_finish(void)
+{
+    longjmp(done_jmp, 1);
+}
+
+/* ===================== File helpers ===================== */
+static uint8_t *read_file(const char *path, size_t *len)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+
+    size_t cap = 4096, n = 0;
+    uint8_t *buf = malloc(cap);
+    size_t r;
+    while (buf && (r = fread(buf + n, 1, cap - n, f)) > 0) {
+        n += r;
+        if (n == cap) buf = realloc(buf, cap *= 2);
+    }
+    fclose(f);
+
+    *len = n;
+    return buf;
+}
+
+static bool load_trace(const char *path)
+{
+    size_t len;
+    uint8_t *buf = read_file(path, &len);
+    if (!buf) return false;
+
+    if (!input_trace_header_ok(buf, len)) {
+        fprintf(stderr, "%s: not an input trace\n", path);
+        free(buf);
+        return false;
+    }
+
+    /* every record is at least 2 bytes */
+    edges = malloc((len / 2 + 1) * sizeof(*edges));
+    device = malloc((len / 3 + 1) * sizeof(*device));
+    uint64_t t = 0;
+    size_t off = INPUT_TRACE_HEADER_LEN;
+
+    while (off < len) {
+        uint32_t delta, value;
+        uint8_t pin;
+        bool rising;
+        size_t n = input_trace_decode(buf + off, len - off, &delta, &pin, &rising, &value);
+        if (n == 0) {
+            fprintf(stderr, "%s: truncated record at byte %zu, ignored\n", path, off);
+            break;
+        }
+        t += delta;
+        off += n;
+
+        if (pin == INPUT_TRACE_PIN_DROP) {
+            if (!edges_lost) first_loss_us = t;
+            edges_lost += value;
+            continue;
+        }
+        if (pin == INPUT_TRACE_PIN_OUTPUT) {
+            device[device_count++] = (device_frame_t){ t, (uint8_t)value };
+            continue;
+        }
+        edges[edge_count++] = (struct input_edge){ t, pin, rising };
+    }
+
+    free(buf);
+    return true;
+}
+
+static void put_le(uint8_t *out, uint64_t v, int bytes)
+{
+    for (int i = 0; i < bytes; i++) out[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint64_t get_le(const uint8_t *in, int bytes)
+{
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; i++) v |= (uint64_t)in[i] << (8 * i);
+    return v;
+}
+
+static bool load_golden(const char *path)
+{
+    size_t len;
+    uint8_t *buf = read_file(path, &len);
+    if (!buf) return false;
+
+    if (len < GOLDEN_HEADER_LEN || memcmp(buf, "IGLD", 4) != 0) {
+        fprintf(stderr, "%s: not a golden trace\n", path);
+        free(buf);
+        return false;
+    }
+
+    size_t n = (len - GOLDEN_HEADER_LEN) / GOLDEN_FRAME_LEN;
+    frame_t *g = malloc((n + 1) * sizeof(*g));
+    for (size_t i = 0; i < n; i++) {
+        const uint8_t *p = buf + GOLDEN_HEADER_LEN + i * GOLDEN_FRAME_LEN;
+        g[i].t_us = get_le(p, 8);
+        g[i].leds = p[8];
+        g[i].pwm  = (uint16_t)get_le(p + 9, 2);
+    }
+
+    free(buf);
+    golden = g;
+    golden_count = n;
+    return true;
+}
+
+static bool save_frames(const char *path)
+{
+    FILE *f = fopen(path, "wb");
+    if (!f) return false;
+
+    uint8_t hdr[GOLDEN_HEADER_LEN] = { 'I', 'G', 'L', 'D', 1, 0, 0, 0 };
+    fwrite(hdr, 1, sizeof(hdr), f);
+
+    for (size_t i = 0; i < frame_count; i++) {
+        uint8_t p[GOLDEN_FRAME_LEN];
+        put_le(p, frames[i].t_us, 8);
+        p[8] = frames[i].leds;
+        put_le(p + 9, frames[i].pwm, 2);
+        fwrite(p, 1, sizeof(p), f);
+    }
+
+    return fclose(f) == 0;
+}
+
+/* ===================== Main ===================== */
+static double wall_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr, "usage: %s TRACE [--golden FILE] [--record FILE] [--tail-ms N]\n", argv0);
+}
+
+int main(int argc, char **argv)
+{
+    const char *trace_path = NULL, *golden_path = NULL, *record_path = NULL;
+    uint64_t tail_ms = 1000;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--golden") && i + 1 < argc)       golden_path = argv[++i];
+        else if (!strcmp(argv[i], "--record") && i + 1 < argc)  record_path = argv[++i];
+        else if (!strcmp(argv[i], "--tail-ms") && i + 1 < argc) tail_ms = strtoull(argv[++i], NULL, 0);
+        else if (argv[i][0] != '-' && !trace_path)              trace_path = argv[i];
+        else { usage(argv[0]); return 2; }
+    }
+    if (!trace_path) { usage(argv[0]); return 2; }
+
+    if (!load_trace(trace_path)) { perror(trace_path); return 2; }
+    if (golden_path && !load_golden(golden_path)) { perror(golden_path); return 2; }
+
+    end_us = edge_count ? edges[edge_count - 1].t_us : 0;
+    if (device_count && device[device_count - 1].t_us > end_us) {
+        end_us = device[device_count - 1].t_us;
+    }
+    end_us += tail_ms * 1000;
+
+    double t0 = wall_s();
+    if (!setjmp(done_jmp)) {
+        replay_target_run();
+    }
+    double elapsed = wall_s() - t0;
+    if (elapsed <= 0) elapsed = 1e-9;
+
+    printf("target      : %s\n", replay_target_name);
+    printf("edges       : %zu of %zu delivered\n", edge_next, edge_count);
+    if (edges_lost) {
+        printf("capture     : LOSSY, %llu edges dropped on the device, first before t=%llu us\n",
+               (unsigned long long)edges_lost, (unsigned long long)first_loss_us);
+    }
+    printf("frames      : %zu\n", frame_count);
+    printf("virtual time: %.3f s\n", now_us / 1e6);
+    printf("wall time   : %.6f s (%.0fx real time)\n", elapsed, now_us / 1e6 / elapsed);
+    printf("throughput  : %.0f events/s, %.0f frames/s\n",
+           edge_next / elapsed, frame_count / elapsed);
+
+    bool mismatch = false;
+
+    if (device_count) {
+        if (frame_count < device_count) {
+            device_mismatch_count += device_count - frame_count;
+            if (device_first_mismatch == SIZE_MAX) device_first_mismatch = frame_count;
+        }
+        if (device_mismatch_count == 0) {
+            printf("device      : match (%zu frames in lockstep)\n", device_count);
+        } else {
+            printf("device      : MISMATCH, %zu of %zu frames differ, first at frame %zu",
+                   device_mismatch_count, device_count, device_first_mismatch);
+            if (device_first_mismatch < frame_count) {
+                const device_frame_t *d = &device[device_first_mismatch];
+                printf(" (t=%llu us host 0x%02x device 0x%02x)", (unsigned long long)d->t_us,
+                       frames[device_first_mismatch].outputs, d->outputs);
+            }
+            printf("\n");
+            mismatch = true;
+        }
+    } else {
+        printf("device      : no output frames in the trace, nothing to check against\n");
+    }
+
+    if (record_path && !save_frames(record_path)) {
+        perror(record_path);
+        return 2;
+    }
+
+    if (golden) {
+        if (frame_count != golden_count) {
+            mismatch_count += frame_count > golden_count ? 0 : golden_count - frame_count;
+            if (first_mismatch == SIZE_MAX) first_mismatch = frame_count;
+        }
+        if (mismatch_count == 0) {
+            printf("golden      : match (%zu frames)\n", golden_count);
+        } else {
+            printf("golden      : MISMATCH, %zu frames differ, first at frame %zu",
+                   mismatch_count, first_mismatch);
+            if (first_mismatch < frame_count) {
+                const frame_t *f = &frames[first_mismatch];
+                printf(" (t=%llu us leds=0x%x pwm=%u",
+                       (unsigned long long)f->t_us, f->leds, f->pwm);
+                if (first_mismatch < golden_count) {
+                    const frame_t *g = &golden[first_mismatch];
+                    printf(", expected t=%llu us leds=0x%x pwm=%u",
+                           (unsigned long long)g->t_us, g->leds, g->pwm);
+                }
+                printf(")");
+            }
+            printf("\n");
+            mismatch = true;
+        }
+    }
+
+    if (mismatch && edges_lost) {
+        printf("capture     : the capture lost edges, so the mismatch may be the capture's\n");
+        return 3;
+    }
+    return mismatch ? 1 : 0;
+}
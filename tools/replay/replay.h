@@ -0,0 +1,56 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+/*
+ * Host replay engine: feeds a recorded input trace into unmodified lab
+ * code on a virtual clock. Time only moves when the app sleeps, so a
+ * trace replays as fast as the host CPU allows.
+ *
+ * Layering:
+ *   replay.c          trace loading, virtual clock, frames, golden check
+ *   shim_*.c          SDK stand-ins, call back into the clock
+ *   target_*.c        #include the lab source and provide the hooks below
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ===================== Virtual clock ===================== */
+uint64_t replay_now_us(void);
+
+/* time of the next undelivered edge, UINT64_MAX when the trace is spent */
+uint64_t replay_next_edge_us(void);
+
+/* Move the clock to t_us, delivering every edge up to it through
+   replay_target_edge(). Returns false once t_us passes the end of the
+   replay window; the caller must stop running app code. */
+bool replay_advance_to(uint64_t t_us);
+
+/* Snapshot the outputs as one frame (called at every app pacing sleep) */
+void replay_frame(void);
+
+/* When a pacing sleep asked to end at t_us really ends: with output
+   frames from the device in the trace, when the device's next loop pass
+   fetched its events, so the replay runs in lockstep with the capture */
+uint64_t replay_pace_us(uint64_t t_us);
+
+/* Leave the app and return to the driver (for apps that never return) */
+void replay_finish(void);
+
+/* ===================== Target hooks ===================== */
+extern const char *const replay_target_name;
+
+/* run the app until replay_advance_to() reports the end */
+void replay_target_run(void);
+
+/* one physical pin edge, in trace order */
+void replay_target_edge(uint8_t pin, bool rising);
+
+/* current output state: LED bitmask and PWM level (0 if unused) */
+uint8_t  replay_target_leds(void);
+uint16_t replay_target_pwm(void);
+
+/* the same state as the device's output frames encode it (input_trace.h) */
+uint8_t  replay_target_outputs(void);
+
+#endif /* REPLAY_H */
@@ -0,0 +1,18 @@
+#ifndef REPLAY_SHIM_HARDWARE_ADDRESS_MAPPED_H
+#define REPLAY_SHIM_HARDWARE_ADDRESS_MAPPED_H
+
+/* The register helpers lab1 uses; no atomic alias on the host */
+
+#include <stdint.h>
+
+static inline void hw_write_masked(volatile uint32_t *addr, uint32_t values, uint32_t mask)
+{
+    *addr = (*addr & ~mask) | (values & mask);
+}
+
+static inline void hw_clear_bits(volatile uint32_t *addr, uint32_t mask)
+{
+    *addr &= ~mask;
+}
+
+#endif /* REPLAY_SHIM_HARDWARE_ADDRESS_MAPPED_H */
@@ -0,0 +1,24 @@
+#ifndef REPLAY_SHIM_HARDWARE_STRUCTS_IO_BANK0_H
+#define REPLAY_SHIM_HARDWARE_STRUCTS_IO_BANK0_H
+
+/* GPIO control registers in host memory; shim_pico.c keeps each pin's
+   function select here, so direct writes and gpio_set_function() agree */
+
+#include "hardware/address_mapped.h"
+
+#define IO_BANK0_GPIO0_CTRL_FUNCSEL_LSB  0
+#define IO_BANK0_GPIO0_CTRL_FUNCSEL_BITS 0x1fu
+
+typedef struct {
+    volatile uint32_t status;
+    volatile uint32_t ctrl;
+} io_bank0_status_ctrl_hw_t;
+
+typedef struct {
+    io_bank0_status_ctrl_hw_t io[48];
+} io_bank0_hw_t;
+
+extern io_bank0_hw_t shim_io_bank0;
+#define io_bank0_hw (&shim_io_bank0)
+
+#endif /* REPLAY_SHIM_HARDWARE_STRUCTS_IO_BANK0_H */
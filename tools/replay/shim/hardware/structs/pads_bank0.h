@@ -0,0 +1,21 @@
+#ifndef REPLAY_SHIM_HARDWARE_STRUCTS_PADS_BANK0_H
+#define REPLAY_SHIM_HARDWARE_STRUCTS_PADS_BANK0_H
+
+/* RP2350 pad control registers in host memory; nothing reads them back */
+
+#include "hardware/address_mapped.h"
+
+#define HAS_PADS_BANK0_ISOLATION  1
+#define PADS_BANK0_GPIO0_ISO_BITS 0x100u
+#define PADS_BANK0_GPIO0_OD_BITS  0x80u
+#define PADS_BANK0_GPIO0_IE_BITS  0x40u
+
+typedef struct {
+    volatile uint32_t voltage_select;
+    volatile uint32_t io[48];
+} pads_bank0_hw_t;
+
+extern pads_bank0_hw_t shim_pads_bank0;
+#define pads_bank0_hw (&shim_pads_bank0)
+
+#endif /* REPLAY_SHIM_HARDWARE_STRUCTS_PADS_BANK0_H */
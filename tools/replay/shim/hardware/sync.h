@@ -0,0 +1,12 @@
+#ifndef REPLAY_SHIM_HARDWARE_SYNC_H
+#define REPLAY_SHIM_HARDWARE_SYNC_H
+
+/* Edges are injected between frames, never inside the code under test,
+   so masking interrupts has nothing to do on the host */
+
+#include <stdint.h>
+
+static inline uint32_t save_and_disable_interrupts(void) { return 0; }
+static inline void restore_interrupts(uint32_t status) { (void)status; }
+
+#endif /* REPLAY_SHIM_HARDWARE_SYNC_H */
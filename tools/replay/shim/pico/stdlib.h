@@ -0,0 +1,48 @@
+#ifndef REPLAY_SHIM_PICO_STDLIB_H
+#define REPLAY_SHIM_PICO_STDLIB_H
+
+/* Host stand-in for the parts of the Pico SDK the labs use */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+/* ---- time: backed by the replay virtual clock ---- */
+absolute_time_t get_absolute_time(void);
+uint32_t to_ms_since_boot(absolute_time_t t);
+int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to);
+uint32_t time_us_32(void);
+void sleep_ms(uint32_t ms);
+
+/* ---- gpio ---- */
+#define GPIO_IN  false
+#define GPIO_OUT true
+
+enum gpio_irq_level {
+    GPIO_IRQ_LEVEL_LOW  = 0x1u,
+    GPIO_IRQ_LEVEL_HIGH = 0x2u,
+    GPIO_IRQ_EDGE_FALL  = 0x4u,
+    GPIO_IRQ_EDGE_RISE  = 0x8u,
+};
+
+enum gpio_function {
+    GPIO_FUNC_SIO = 5,
+    GPIO_FUNC_PWM = 4,
+};
+
+typedef void (*gpio_irq_callback_t)(uint gpio, uint32_t event_mask);
+
+void gpio_init(uint gpio);
+void gpio_set_dir(uint gpio, bool out);
+void gpio_pull_up(uint gpio);
+void gpio_put(uint gpio, bool value);
+bool gpio_get(uint gpio);
+void gpio_set_function(uint gpio, enum gpio_function fn);
+void gpio_set_irq_enabled(uint gpio, uint32_t event_mask, bool enabled);
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask, bool enabled,
+                                        gpio_irq_callback_t callback);
+
+#endif /* REPLAY_SHIM_PICO_STDLIB_H */
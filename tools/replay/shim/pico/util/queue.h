@@ -0,0 +1,19 @@
+#ifndef REPLAY_SHIM_PICO_UTIL_QUEUE_H
+#define REPLAY_SHIM_PICO_UTIL_QUEUE_H
+
+#include "pico/stdlib.h"
+
+typedef struct {
+    uint8_t *data;
+    uint16_t wptr;
+    uint16_t rptr;
+    uint16_t element_size;
+    uint16_t element_count;
+} queue_t;
+
+void queue_init(queue_t *q, uint element_size, uint element_count);
+bool queue_try_add(queue_t *q, const void *data);
+bool queue_try_remove(queue_t *q, void *data);
+uint queue_get_level(queue_t *q);
+
+#endif /* REPLAY_SHIM_PICO_UTIL_QUEUE_H */
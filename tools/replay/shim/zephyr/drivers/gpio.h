@@ -0,0 +1,65 @@
+#ifndef REPLAY_SHIM_ZEPHYR_DRIVERS_GPIO_H
+#define REPLAY_SHIM_ZEPHYR_DRIVERS_GPIO_H
+
+#include <zephyr/kernel.h>
+
+struct device {
+	const char *name;
+};
+
+typedef uint8_t gpio_pin_t;
+typedef uint32_t gpio_flags_t;
+typedef uint32_t gpio_port_pins_t;
+
+#define GPIO_ACTIVE_LOW         (1u << 0)
+#define GPIO_PULL_UP            (1u << 4)
+#define GPIO_INPUT              (1u << 16)
+#define GPIO_OUTPUT             (1u << 17)
+#define GPIO_OUTPUT_INIT_LOW    (1u << 18)
+#define GPIO_OUTPUT_INIT_HIGH   (1u << 19)
+#define GPIO_OUTPUT_INIT_LOGICAL (1u << 20)
+#define GPIO_OUTPUT_INACTIVE    (GPIO_OUTPUT | GPIO_OUTPUT_INIT_LOW | GPIO_OUTPUT_INIT_LOGICAL)
+#define GPIO_OUTPUT_ACTIVE      (GPIO_OUTPUT | GPIO_OUTPUT_INIT_HIGH | GPIO_OUTPUT_INIT_LOGICAL)
+
+#define GPIO_INT_DISABLE        0u
+#define GPIO_INT_EDGE_TO_ACTIVE 1u
+#define GPIO_INT_EDGE_TO_INACTIVE 2u
+#define GPIO_INT_EDGE_BOTH      3u
+
+struct gpio_dt_spec {
+	const struct device *port;
+	gpio_pin_t pin;
+	gpio_flags_t dt_flags;
+};
+
+/*
+ * Devicetree stand-in: the replay target defines DT_SHIM_ALIAS_<alias>
+ * as (pin | dt_flags << 8) to mirror the board overlay.
+ */
+extern const struct device shim_gpio0;
+
+#define DT_ALIAS(alias)               DT_SHIM_ALIAS_##alias
+#define GPIO_DT_SPEC_GET(node, prop)  { &shim_gpio0, (node) & 0xff, (node) >> 8 }
+
+struct gpio_callback;
+typedef void (*gpio_callback_handler_t)(const struct device *port, struct gpio_callback *cb,
+					gpio_port_pins_t pins);
+
+struct gpio_callback {
+	struct gpio_callback *next;
+	gpio_callback_handler_t handler;
+	gpio_port_pins_t pin_mask;
+};
+
+bool gpio_is_ready_dt(const struct gpio_dt_spec *spec);
+int gpio_pin_configure_dt(const struct gpio_dt_spec *spec, gpio_flags_t extra_flags);
+int gpio_pin_interrupt_configure_dt(const struct gpio_dt_spec *spec, gpio_flags_t flags);
+int gpio_pin_get_dt(const struct gpio_dt_spec *spec);
+int gpio_pin_set_dt(const struct gpio_dt_spec *spec, int value);
+int gpio_pin_toggle_dt(const struct gpio_dt_spec *spec);
+
+void gpio_init_callback(struct gpio_callback *cb, gpio_callback_handler_t handler,
+			gpio_port_pins_t pin_mask);
+int gpio_add_callback(const struct device *port, struct gpio_callback *cb);
+
+#endif /* REPLAY_SHIM_ZEPHYR_DRIVERS_GPIO_H */
@@ -0,0 +1,77 @@
+#ifndef REPLAY_SHIM_ZEPHYR_KERNEL_H
+#define REPLAY_SHIM_ZEPHYR_KERNEL_H
+
+/*
+ * Host stand-in for the Zephyr kernel APIs the labs use. Threads are
+ * cooperative (ucontext) and every blocking call yields to a scheduler
+ * that runs on the replay virtual clock.
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define ARG_UNUSED(x) (void)(x)
+#define BIT(n)        (1UL << (n))
+
+/* ---- timeouts, in virtual microseconds ---- */
+typedef struct {
+	int64_t us;
+} k_timeout_t;
+
+#define K_NO_WAIT     ((k_timeout_t){ 0 })
+#define K_FOREVER     ((k_timeout_t){ -1 })
+#define K_USEC(t)     ((k_timeout_t){ (int64_t)(t) })
+#define K_MSEC(t)     ((k_timeout_t){ (int64_t)(t) * 1000 })
+#define K_SECONDS(t)  ((k_timeout_t){ (int64_t)(t) * 1000000 })
+
+/* ---- threads ---- */
+typedef void (*k_thread_entry_t)(void *p1, void *p2, void *p3);
+typedef struct shim_thread *k_tid_t;
+
+void shim_thread_register(const char *name, k_thread_entry_t entry,
+			  void *p1, void *p2, void *p3, int prio);
+
+/* threads start once the app's main() has returned, as with delay 0 */
+#define K_THREAD_DEFINE(name, stack_size, entry, p1, p2, p3, prio, options, delay)	\
+	static void __attribute__((constructor)) shim_thread_reg_##name(void)		\
+	{										\
+		shim_thread_register(#name, (k_thread_entry_t)(entry),			\
+				     (void *)(p1), (void *)(p2), (void *)(p3), (prio));	\
+	}										\
+	const k_tid_t name = NULL
+
+int32_t k_msleep(int32_t ms);
+int32_t k_sleep(k_timeout_t timeout);
+void k_yield(void);
+uint32_t k_uptime_get_32(void);
+int64_t k_uptime_get(void);
+
+/* one cycle per virtual microsecond */
+uint32_t k_cycle_get_32(void);
+static inline uint32_t k_cyc_to_us_floor32(uint32_t cyc) { return cyc; }
+
+/* ---- semaphores ---- */
+struct k_sem {
+	unsigned int count;
+	unsigned int limit;
+};
+
+#define K_SEM_DEFINE(name, initial, max) struct k_sem name = { (initial), (max) }
+
+int k_sem_init(struct k_sem *sem, unsigned int initial_count, unsigned int limit);
+int k_sem_take(struct k_sem *sem, k_timeout_t timeout);
+void k_sem_give(struct k_sem *sem);
+unsigned int k_sem_count_get(struct k_sem *sem);
+
+/* ---- mutexes: no preemption, so never contended ---- */
+struct k_mutex {
+	int lock_count;
+};
+
+int k_mutex_init(struct k_mutex *mutex);
+int k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout);
+int k_mutex_unlock(struct k_mutex *mutex);
+
+#endif /* REPLAY_SHIM_ZEPHYR_KERNEL_H */
@@ -0,0 +1,242 @@
+/*
+ * Pico SDK shim for host replay. GPIO, PWM and queues are plain arrays;
+ * time comes from the replay virtual clock, and sleep_ms() is where the
+ * app yields to it. lab1's deadline alarm (lab1/deadline.c) is register
+ * glue, so it is stood in for here too.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "pico/util/queue.h"
+#include "hardware/pwm.h"
+#include "hardware/structs/io_bank0.h"
+#include "hardware/structs/pads_bank0.h"
+
+#include "deadline.h"
+#include "replay.h"
+#include "shim_pico.h"
+
+#define NUM_GPIO     48
+#define NUM_PWM      12
+
+static struct {
+    bool level;
+    bool out;
+    uint32_t irq_mask;
+} gpio[NUM_GPIO];
+
+/* function select lives in the register lab1 may write directly */
+io_bank0_hw_t shim_io_bank0;
+pads_bank0_hw_t shim_pads_bank0;
+
+static struct {
+    bool enabled;
+    uint16_t level[2];
+} pwm[NUM_PWM];
+
+static gpio_irq_callback_t irq_callback;
+
+static struct {
+    bool armed;
+    uint64_t t_us;
+    deadline_cb_t cb;
+} alarm;
+
+/* ===================== Time ===================== */
+absolute_time_t get_absolute_time(void)
+{
+    return replay_now_us();
+}
+
+uint32_t to_ms_since_boot(absolute_time_t t)
+{
+    return (uint32_t)(t / 1000);
+}
+
+int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to)
+{
+    return (int64_t)(to - from);
+}
+
+uint32_t time_us_32(void)
+{
+    return (uint32_t)replay_now_us();
+}
+
+/* advance to t_us, delivering edges and firing the alarm in time order */
+static void run_until(uint64_t t_us)
+{
+    for (;;) {
+        uint64_t step = t_us;
+        uint64_t edge = replay_next_edge_us();
+
+        if (alarm.armed && alarm.t_us < step) step = alarm.t_us;
+        if (edge < step) step = edge;
+
+        if (!replay_advance_to(step)) {
+            replay_finish();
+        }
+
+        if (alarm.armed && alarm.t_us <= replay_now_us()) {
+            alarm.armed = false;
+            alarm.cb((uint32_t)replay_now_us());
+        }
+        if (step == t_us) return;
+    }
+}
+
+void sleep_ms(uint32_t ms)
+{
+    /* the app paces itself here, so this is one output frame */
+    replay_frame();
+    run_until(replay_pace_us(replay_now_us() + (uint64_t)ms * 1000));
+}
+
+/* ===================== Deadline alarm ===================== */
+void deadline_init(deadline_cb_t cb)
+{
+    alarm.cb = cb;
+    alarm.armed = false;
+}
+
+void deadline_set(uint32_t t_us)
+{
+    uint64_t now = replay_now_us();
+    int32_t ahead = (int32_t)(t_us - (uint32_t)now);
+
+    alarm.t_us = ahead > 0 ? now + (uint64_t)ahead : now;
+    alarm.armed = true;
+}
+
+void deadline_cancel(void)
+{
+    alarm.armed = false;
+}
+
+/* ===================== GPIO ===================== */
+void gpio_init(uint g)
+{
+    gpio[g].level = false;
+    gpio[g].out = false;
+    gpio_set_function(g, GPIO_FUNC_SIO);
+}
+
+void gpio_set_dir(uint g, bool out)      { gpio[g].out = out; }
+void gpio_pull_up(uint g)                { if (!gpio[g].out) gpio[g].level = true; }
+void gpio_put(uint g, bool value)        { if (gpio[g].out) gpio[g].level = value; }
+bool gpio_get(uint g)                    { return gpio[g].level; }
+
+void gpio_set_function(uint g, enum gpio_function fn)
+{
+    io_bank0_hw->io[g].ctrl = (uint32_t)fn << IO_BANK0_GPIO0_CTRL_FUNCSEL_LSB;
+}
+
+static uint32_t gpio_fn(uint g)
+{
+    return (io_bank0_hw->io[g].ctrl & IO_BANK0_GPIO0_CTRL_FUNCSEL_BITS) >> IO_BANK0_GPIO0_CTRL_FUNCSEL_LSB;
+}
+
+void gpio_set_irq_enabled(uint g, uint32_t event_mask, bool enabled)
+{
+    if (enabled) gpio[g].irq_mask |= event_mask;
+    else         gpio[g].irq_mask &= ~event_mask;
+}
+
+void gpio_set_irq_enabled_with_callback(uint g, uint32_t event_mask, bool enabled,
+                                        gpio_irq_callback_t callback)
+{
+    gpio_set_irq_enabled(g, event_mask, enabled);
+    irq_callback = callback;
+}
+
+void shim_pico_edge(uint g, bool rising)
+{
+    if (g >= NUM_GPIO || gpio[g].out) return;
+
+    gpio[g].level = rising;
+
+    uint32_t evt = rising ? GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL;
+    if (irq_callback && (gpio[g].irq_mask & evt)) {
+        irq_callback(g, evt);
+    }
+}
+
+bool shim_pico_gpio_level(uint g)
+{
+    return gpio_fn(g) == GPIO_FUNC_SIO && gpio[g].out && gpio[g].level;
+}
+
+bool shim_pico_gpio_is_pwm(uint g)
+{
+    return gpio_fn(g) == GPIO_FUNC_PWM;
+}
+
+uint16_t shim_pico_pwm_level(uint g)
+{
+    if (!shim_pico_pwm_running(g)) return 0;
+    return pwm[pwm_gpio_to_slice_num(g)].level[pwm_gpio_to_channel(g)];
+}
+
+bool shim_pico_pwm_running(uint g)
+{
+    return shim_pico_gpio_is_pwm(g) && pwm[pwm_gpio_to_slice_num(g)].enabled;
+}
+
+/* ===================== PWM ===================== */
+uint pwm_gpio_to_slice_num(uint g) { return (g >> 1) % NUM_PWM; }
+uint pwm_gpio_to_channel(uint g)   { return g & 1; }
+
+pwm_config pwm_get_default_config(void)
+{
+    pwm_config c = { 1.0f, 0xffff };
+    return c;
+}
+
+void pwm_config_set_clkdiv(pwm_config *c, float div) { c->clkdiv = div; }
+void pwm_config_set_wrap(pwm_config *c, uint16_t wrap) { c->wrap = wrap; }
+
+void pwm_init(uint slice, pwm_config *c, bool start)
+{
+    (void)c;
+    pwm[slice].enabled = start;
+    pwm[slice].level[0] = pwm[slice].level[1] = 0;
+}
+
+void pwm_set_chan_level(uint slice, uint chan, uint16_t level) { pwm[slice].level[chan] = level; }
+void pwm_set_enabled(uint slice, bool enabled) { pwm[slice].enabled = enabled; }
+
+/* ===================== Queue ===================== */
+void queue_init(queue_t *q, uint element_size, uint element_count)
+{
+    /* one spare slot tells full from empty, as in the SDK */
+    q->data = calloc(element_count + 1, element_size);
+    q->element_size = (uint16_t)element_size;
+    q->element_count = (uint16_t)element_count;
+    q->wptr = q->rptr = 0;
+}
+
+bool queue_try_add(queue_t *q, const void *data)
+{
+    uint16_t next = (uint16_t)((q->wptr + 1) % (q->element_count + 1));
+    if (next == q->rptr) return false;
+
+    memcpy(q->data + (size_t)q->wptr * q->element_size, data, q->element_size);
+    q->wptr = next;
+    return true;
+}
+
+bool queue_try_remove(queue_t *q, void *data)
+{
+    if (q->rptr == q->wptr) return false;
+
+    memcpy(data, q->data + (size_t)q->rptr * q->element_size, q->element_size);
+    q->rptr = (uint16_t)((q->rptr + 1) % (q->element_count + 1));
+    return true;
+}
+
+uint queue_get_level(queue_t *q)
+{
+    return (q->wptr + q->element_count + 1 - q->rptr) % (q->element_count + 1);
+}
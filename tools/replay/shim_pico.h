@@ -0,0 +1,16 @@
+#ifndef REPLAY_SHIM_PICO_H
+#define REPLAY_SHIM_PICO_H
+
+/* Replay-side view of the Pico SDK shim state */
+
+#include "pico/stdlib.h"
+
+/* drive an input pin and raise its IRQ callback if the edge is enabled */
+void shim_pico_edge(uint gpio, bool rising);
+
+bool shim_pico_gpio_level(uint gpio);
+bool shim_pico_gpio_is_pwm(uint gpio);
+uint16_t shim_pico_pwm_level(uint gpio);
+bool shim_pico_pwm_running(uint gpio);
+
+#endif /* REPLAY_SHIM_PICO_H */
@@ -0,0 +1,346 @@
+/*
+ * Zephyr shim for host replay.
+ *
+ * Threads run cooperatively on ucontext stacks. The scheduler always
+ * picks the highest priority ready thread; when none is ready it moves
+ * the virtual clock to the next wakeup or trace edge, whichever comes
+ * first. Edges raise gpio callbacks in "ISR" context on the scheduler
+ * stack, exactly between two thread slices.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <ucontext.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/gpio.h>
+
+#include "replay.h"
+#include "shim_zephyr.h"
+
+#define MAX_THREADS   16
+#define STACK_BYTES   (256 * 1024)
+#define NUM_PINS      48
+
+enum thread_state { T_READY, T_SLEEP, T_SEM };
+
+struct shim_thread {
+	const char *name;
+	k_thread_entry_t entry;
+	void *p1, *p2, *p3;
+	int prio;
+
+	ucontext_t ctx;
+	enum thread_state state;
+	uint64_t wake_us;       // UINT64_MAX = no timeout
+	struct k_sem *sem;
+	bool timed_out;
+};
+
+static struct shim_thread threads[MAX_THREADS];
+static int thread_count;
+static struct shim_thread *current;
+static ucontext_t sched_ctx;
+static int rr_next;
+
+const struct device shim_gpio0 = { "gpio0" };
+
+static struct {
+	bool level;     // physical
+	gpio_flags_t flags;
+	gpio_flags_t int_mode;
+} pins[NUM_PINS];
+
+static struct gpio_callback *callbacks;
+
+/* ===================== Threads ===================== */
+void shim_thread_register(const char *name, k_thread_entry_t entry,
+			  void *p1, void *p2, void *p3, int prio)
+{
+	if (thread_count == MAX_THREADS) {
+		fprintf(stderr, "shim: too many threads\n");
+		exit(2);
+	}
+	threads[thread_count++] = (struct shim_thread){
+		.name = name, .entry = entry, .p1 = p1, .p2 = p2, .p3 = p3, .prio = prio,
+	};
+}
+
+static void thread_trampoline(void)
+{
+	current->entry(current->p1, current->p2, current->p3);
+
+	/* a returning thread simply never runs again */
+	current->state = T_SLEEP;
+	current->wake_us = UINT64_MAX;
+	swapcontext(&current->ctx, &sched_ctx);
+}
+
+static void block(void)
+{
+	swapcontext(&current->ctx, &sched_ctx);
+}
+
+static struct shim_thread *pick_ready(void)
+{
+	struct shim_thread *best = NULL;
+
+	/* round robin among equal priorities, starting after the last pick */
+	for (int n = 0; n < thread_count; n++) {
+		struct shim_thread *t = &threads[(rr_next + n) % thread_count];
+		if (t->state == T_READY && (!best || t->prio < best->prio)) {
+			best = t;
+		}
+	}
+	if (best) {
+		rr_next = (int)(best - threads) + 1;
+	}
+	return best;
+}
+
+static void wake_expired(void)
+{
+	uint64_t now = replay_now_us();
+
+	for (int i = 0; i < thread_count; i++) {
+		struct shim_thread *t = &threads[i];
+		if (t->state != T_READY && t->wake_us <= now) {
+			t->timed_out = (t->state == T_SEM);
+			t->state = T_READY;
+		}
+	}
+}
+
+void shim_zephyr_run(void)
+{
+	for (int i = 0; i < thread_count; i++) {
+		struct shim_thread *t = &threads[i];
+		getcontext(&t->ctx);
+		t->ctx.uc_stack.ss_sp = malloc(STACK_BYTES);
+		t->ctx.uc_stack.ss_size = STACK_BYTES;
+		t->ctx.uc_link = &sched_ctx;
+		makecontext(&t->ctx, thread_trampoline, 0);
+		t->state = T_READY;
+		t->wake_us = UINT64_MAX;
+	}
+
+	while (1) {
+		struct shim_thread *t = pick_ready();
+		if (t) {
+			current = t;
+			swapcontext(&sched_ctx, &t->ctx);
+			current = NULL;
+			continue;
+		}
+
+		uint64_t next = replay_next_edge_us();
+		for (int i = 0; i < thread_count; i++) {
+			if (threads[i].wake_us < next) next = threads[i].wake_us;
+		}
+		if (next == UINT64_MAX || !replay_advance_to(next)) {
+			return;
+		}
+		wake_expired();
+	}
+}
+
+static void sleep_until(uint64_t t_us)
+{
+	replay_frame();
+
+	if (!current) {
+		/* main() before the scheduler starts */
+		if (!replay_advance_to(t_us)) replay_finish();
+		return;
+	}
+
+	current->state = T_SLEEP;
+	current->wake_us = t_us;
+	block();
+	current->wake_us = UINT64_MAX;
+}
+
+int32_t k_msleep(int32_t ms)
+{
+	sleep_until(replay_now_us() + (uint64_t)ms * 1000);
+	return 0;
+}
+
+int32_t k_sleep(k_timeout_t timeout)
+{
+	if (timeout.us < 0) {
+		sleep_until(UINT64_MAX);
+	} else {
+		sleep_until(replay_now_us() + (uint64_t)timeout.us);
+	}
+	return 0;
+}
+
+void k_yield(void)
+{
+	if (current) block();
+}
+
+uint32_t k_uptime_get_32(void)
+{
+	return (uint32_t)(replay_now_us() / 1000);
+}
+
+uint32_t k_cycle_get_32(void)
+{
+	return (uint32_t)replay_now_us();
+}
+
+int64_t k_uptime_get(void)
+{
+	return (int64_t)(replay_now_us() / 1000);
+}
+
+/* ===================== Semaphores / mutexes ===================== */
+int k_sem_init(struct k_sem *sem, unsigned int initial_count, unsigned int limit)
+{
+	sem->count = initial_count;
+	sem->limit = limit;
+	return 0;
+}
+
+int k_sem_take(struct k_sem *sem, k_timeout_t timeout)
+{
+	if (sem->count == 0) {
+		if (timeout.us == 0) return -EBUSY;
+		if (!current) return -EAGAIN;
+
+		current->sem = sem;
+		current->timed_out = false;
+		current->wake_us = timeout.us < 0 ? UINT64_MAX : replay_now_us() + (uint64_t)timeout.us;
+
+		/* a give may be consumed by another thread before we run */
+		while (sem->count == 0 && !current->timed_out) {
+			current->state = T_SEM;
+			block();
+		}
+		current->sem = NULL;
+		current->wake_us = UINT64_MAX;
+		if (sem->count == 0) return -EAGAIN;
+	}
+
+	sem->count--;
+	return 0;
+}
+
+void k_sem_give(struct k_sem *sem)
+{
+	if (sem->count < sem->limit) sem->count++;
+
+	for (int i = 0; i < thread_count; i++) {
+		if (threads[i].state == T_SEM && threads[i].sem == sem) {
+			threads[i].state = T_READY;
+			break;
+		}
+	}
+}
+
+unsigned int k_sem_count_get(struct k_sem *sem)
+{
+	return sem->count;
+}
+
+int k_mutex_init(struct k_mutex *mutex)   { mutex->lock_count = 0; return 0; }
+int k_mutex_unlock(struct k_mutex *mutex) { mutex->lock_count--; return 0; }
+
+int k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout)
+{
+	ARG_UNUSED(timeout);
+	mutex->lock_count++;
+	return 0;
+}
+
+/* ===================== GPIO ===================== */
+bool gpio_is_ready_dt(const struct gpio_dt_spec *spec)
+{
+	return spec->port != NULL && spec->pin < NUM_PINS;
+}
+
+int gpio_pin_configure_dt(const struct gpio_dt_spec *spec, gpio_flags_t extra_flags)
+{
+	gpio_flags_t flags = spec->dt_flags | extra_flags;
+	bool active_low = flags & GPIO_ACTIVE_LOW;
+
+	pins[spec->pin].flags = flags;
+	if (flags & GPIO_OUTPUT) {
+		bool logical = flags & GPIO_OUTPUT_INIT_HIGH;
+		pins[spec->pin].level = logical != active_low;
+	} else if (flags & GPIO_PULL_UP) {
+		pins[spec->pin].level = true;
+	}
+	return 0;
+}
+
+int gpio_pin_interrupt_configure_dt(const struct gpio_dt_spec *spec, gpio_flags_t flags)
+{
+	pins[spec->pin].int_mode = flags;
+	return 0;
+}
+
+int gpio_pin_get_dt(const struct gpio_dt_spec *spec)
+{
+	bool active_low = pins[spec->pin].flags & GPIO_ACTIVE_LOW;
+	return pins[spec->pin].level != active_low;
+}
+
+int gpio_pin_set_dt(const struct gpio_dt_spec *spec, int value)
+{
+	bool active_low = pins[spec->pin].flags & GPIO_ACTIVE_LOW;
+	pins[spec->pin].level = (value != 0) != active_low;
+	return 0;
+}
+
+int gpio_pin_toggle_dt(const struct gpio_dt_spec *spec)
+{
+	pins[spec->pin].level = !pins[spec->pin].level;
+	return 0;
+}
+
+void gpio_init_callback(struct gpio_callback *cb, gpio_callback_handler_t handler,
+			gpio_port_pins_t pin_mask)
+{
+	cb->next = NULL;
+	cb->handler = handler;
+	cb->pin_mask = pin_mask;
+}
+
+int gpio_add_callback(const struct device *port, struct gpio_callback *cb)
+{
+	ARG_UNUSED(port);
+	cb->next = callbacks;
+	callbacks = cb;
+	return 0;
+}
+
+void shim_zephyr_edge(gpio_pin_t pin, bool rising)
+{
+	if (pin >= NUM_PINS || (pins[pin].flags & GPIO_OUTPUT)) return;
+
+	pins[pin].level = rising;
+
+	bool active_low = pins[pin].flags & GPIO_ACTIVE_LOW;
+	bool to_active = rising != active_low;
+	gpio_flags_t mode = pins[pin].int_mode;
+
+	bool fire = (mode == GPIO_INT_EDGE_BOTH) ||
+		    (mode == GPIO_INT_EDGE_TO_ACTIVE && to_active) ||
+		    (mode == GPIO_INT_EDGE_TO_INACTIVE && !to_active);
+	if (!fire) return;
+
+	for (struct gpio_callback *cb = callbacks; cb; cb = cb->next) {
+		if (cb->pin_mask & BIT(pin)) {
+			cb->handler(&shim_gpio0, cb, BIT(pin));
+		}
+	}
+}
+
+bool shim_zephyr_pin_level(gpio_pin_t pin)
+{
+	return (pins[pin].flags & GPIO_OUTPUT) && pins[pin].level;
+}
@@ -0,0 +1,18 @@
+#ifndef REPLAY_SHIM_ZEPHYR_H
+#define REPLAY_SHIM_ZEPHYR_H
+
+/* Replay-side view of the Zephyr shim state */
+
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/gpio.h>
+
+/* run registered threads until the replay window ends */
+void shim_zephyr_run(void);
+
+/* drive an input pin and raise matching gpio callbacks */
+void shim_zephyr_edge(gpio_pin_t pin, bool rising);
+
+/* physical output level of a pin */
+bool shim_zephyr_pin_level(gpio_pin_t pin);
+
+#endif /* REPLAY_SHIM_ZEPHYR_H */
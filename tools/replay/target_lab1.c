@@ -0,0 +1,43 @@
+/* Replay target: lab1/lab1.c, compiled unmodified against the Pico shim */
+
+#include "input_trace.h"
+#include "replay.h"
+#include "shim_pico.h"
+
+#define main lab1_main
+#include "lab1.c"
+#undef main
+
+const char *const replay_target_name = "lab1";
+
+void replay_target_run(void)
+{
+    lab1_main();
+}
+
+void replay_target_edge(uint8_t pin, bool rising)
+{
+    shim_pico_edge(pin, rising);
+}
+
+uint8_t replay_target_leds(void)
+{
+    static const uint pins[] = { LED1_GPIO, LED2_GPIO, LED3_GPIO, LED4_GPIO };
+    uint8_t mask = 0;
+
+    for (int i = 0; i < 4; i++) {
+        if (shim_pico_gpio_level(pins[i])) mask |= 1u << i;
+    }
+    return mask;
+}
+
+uint16_t replay_target_pwm(void)
+{
+    return shim_pico_pwm_level(LED1_GPIO);
+}
+
+/* as trace_outputs() in lab1.c */
+uint8_t replay_target_outputs(void)
+{
+    return replay_target_leds() | (shim_pico_pwm_running(LED1_GPIO) ? INPUT_TRACE_OUT_PWM : 0);
+}
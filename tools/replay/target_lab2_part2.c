@@ -0,0 +1,49 @@
+/* Replay target: lab2/part2/src/main.c, compiled unmodified against the Zephyr shim */
+
+#include "replay.h"
+#include "shim_zephyr.h"
+
+/* board overlay: LEDs on GP0..GP3, sw0 on GP20 active low with pull-up */
+#define DT_SHIM_ALIAS_led0 0
+#define DT_SHIM_ALIAS_led1 1
+#define DT_SHIM_ALIAS_led2 2
+#define DT_SHIM_ALIAS_led3 3
+#define DT_SHIM_ALIAS_sw0  (20 | ((GPIO_PULL_UP | GPIO_ACTIVE_LOW) << 8))
+
+#define main lab2_part2_main
+#include "main.c"
+#undef main
+
+const char *const replay_target_name = "lab2/part2";
+
+void replay_target_run(void)
+{
+	lab2_part2_main();
+	shim_zephyr_run();
+}
+
+void replay_target_edge(uint8_t pin, bool rising)
+{
+	shim_zephyr_edge(pin, rising);
+}
+
+uint8_t replay_target_leds(void)
+{
+	uint8_t mask = 0;
+
+	for (int i = 0; i < 4; i++) {
+		if (shim_zephyr_pin_level(leds[i].pin)) mask |= 1u << i;
+	}
+	return mask;
+}
+
+uint16_t replay_target_pwm(void)
+{
+	return 0;
+}
+
+/* the lab2 capture records edges only */
+uint8_t replay_target_outputs(void)
+{
+	return replay_target_leds();
+}
@@ -0,0 +1,237 @@
+/*
+ * Raw BME680 path benchmark on an emulated sensor.
+ *
+ *   seq_bench [--n N] [--os T,P,H] [--filter F] [--profiles C:MS,C:MS,...]
+ *
+ * Runs lab3/common/bme680_raw.c and bme680_seq.c unmodified against the
+ * register model in bme680_model.c on a simulated 400 kHz I2C bus, and
+ * compares two ways of cycling through heater profiles:
+ *   - serial: program set-point 0, trigger, wait, read; one after another
+ *   - seq:    bme680_seq, next set-point written during the conversion
+ * For each profile it reports measurements per second, I2C transactions
+ * and bus time per measurement, and checks the compensated T/P/H against
+ * the environment the model was given.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+
+#include "bme680_model.h"
+#include "bme680_raw.h"
+#include "bme680_seq.h"
+#include "sim.h"
+
+#define ADDR 0x77
+
+/* environment reported by the model */
+#define ENV_TEMP  2250      // 0.01 C
+#define ENV_PRESS 101325    // Pa
+#define ENV_HUM   45000     // 0.001 %RH
+#define ENV_GAS   50000     // ohm at 300 C
+
+static const struct device bus = { "i2c0" };
+
+struct profile_result {
+    uint32_t count;
+    uint64_t elapsed_us;
+    struct sim_bus_stats bus;
+    int32_t max_dt, max_dp, max_dh;    // worst compensation error
+};
+
+static void track_error(struct profile_result *r, const struct bme680_data *d,
+                        const struct bme680_raw_cfg *cfg)
+{
+    int32_t dt = abs(d->temp - ENV_TEMP);
+    int32_t dp = cfg->os_p ? abs((int32_t)d->press - ENV_PRESS) : 0;
+    int32_t dh = cfg->os_h ? abs((int32_t)d->hum - ENV_HUM) : 0;
+
+    if (dt > r->max_dt) r->max_dt = dt;
+    if (dp > r->max_dp) r->max_dp = dp;
+    if (dh > r->max_dh) r->max_dh = dh;
+}
+
+static void add_bus(struct profile_result *r, const struct sim_bus_stats *before)
+{
+    struct sim_bus_stats now;
+
+    sim_bus_get_stats(&now);
+    r->bus.transactions += now.transactions - before->transactions;
+    r->bus.bytes += now.bytes - before->bytes;
+    r->bus.busy_us += now.busy_us - before->busy_us;
+}
+
+/* ===================== Strategies ===================== */
+static int run_serial(struct bme680_raw *dev, const struct bme680_heater_profile *p,
+                      size_t count, uint32_t n, struct profile_result *res)
+{
+    int32_t amb_c = 25;
+
+    for (uint32_t i = 0; i < n * count; i++) {
+        size_t idx = i % count;
+        struct profile_result *r = &res[idx];
+        struct sim_bus_stats before;
+        struct bme680_data d;
+        uint64_t t0 = sim_now_us();
+        int rc;
+
+        sim_bus_get_stats(&before);
+        if (p[idx].temp_c) {
+            rc = bme680_raw_set_heater(dev, 0, p[idx].temp_c, p[idx].dur_ms, amb_c);
+            if (rc) return rc;
+        }
+        rc = bme680_raw_trigger(dev, p[idx].temp_c ? 0 : -1);
+        if (rc) return rc;
+
+        k_usleep(bme680_raw_duration_us(dev, p[idx].temp_c ? p[idx].dur_ms : 0));
+        while ((rc = bme680_raw_read(dev, &d)) == -EBUSY) {
+            k_usleep(500);
+        }
+        if (rc) return rc;
+
+        amb_c = d.temp / 100;
+        r->count++;
+        r->elapsed_us += sim_now_us() - t0;
+        add_bus(r, &before);
+        track_error(r, &d, &dev->cfg);
+    }
+    return 0;
+}
+
+static int run_seq(struct bme680_raw *dev, const struct bme680_heater_profile *p,
+                   size_t count, uint32_t n, struct profile_result *res)
+{
+    static struct bme680_seq seq;
+    int rc = bme680_seq_start(&seq, dev, p, count);
+    if (rc) return rc;
+
+    for (uint32_t i = 0; i < n * count; i++) {
+        struct sim_bus_stats before;
+        struct bme680_data d;
+        uint64_t t0 = sim_now_us();
+        size_t idx;
+
+        sim_bus_get_stats(&before);
+        rc = bme680_seq_step(&seq, &d, &idx);
+        if (rc) return rc;
+
+        res[idx].count++;
+        res[idx].elapsed_us += sim_now_us() - t0;
+        add_bus(&res[idx], &before);
+        track_error(&res[idx], &d, &dev->cfg);
+    }
+
+    bme680_seq_print_stats(&seq);
+    return 0;
+}
+
+/* ===================== Report ===================== */
+static void report(const char *mode, const struct bme680_heater_profile *p, size_t count,
+                   const struct profile_result *res)
+{
+    uint64_t total_us = 0;
+    uint32_t total = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        const struct profile_result *r = &res[i];
+        if (!r->count) continue;
+
+        printf("%-7s %4u C %4u ms %9.2f %8.1f %9.0f %7.2f %6u %7.3f\n", mode,
+               p[i].temp_c, p[i].dur_ms,
+               r->count * 1e6 / r->elapsed_us,
+               (double)r->bus.transactions / r->count,
+               (double)r->bus.busy_us / r->count,
+               r->max_dt / 100.0, (unsigned)r->max_dp, r->max_dh / 1000.0);
+        total_us += r->elapsed_us;
+        total += r->count;
+    }
+    printf("%-7s all profiles: %.2f meas/s\n\n", mode, total * 1e6 / total_us);
+}
+
+static size_t parse_profiles(const char *s, struct bme680_heater_profile *out)
+{
+    size_t n = 0;
+
+    while (*s && n < BME680_SEQ_MAX_PROFILES) {
+        unsigned c, ms;
+        if (sscanf(s, "%u:%u", &c, &ms) != 2) break;
+        out[n].temp_c = (uint16_t)c;
+        out[n].dur_ms = (uint16_t)ms;
+        n++;
+        s = strchr(s, ',');
+        if (!s) break;
+        s++;
+    }
+    return n;
+}
+
+int main(int argc, char **argv)
+{
+    struct bme680_heater_profile profiles[BME680_SEQ_MAX_PROFILES] = {
+        { 0, 0 },       // T/P/H only
+        { 200, 100 },
+        { 300, 100 },
+        { 320, 150 },
+        { 400, 40 },
+    };
+    size_t count = 5;
+    uint32_t n = 100;
+    struct bme680_raw_cfg cfg = { BME680_OS_2X, BME680_OS_16X, BME680_OS_1X, BME680_FILTER_3 };
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--n")) {
+            n = strtoul(argv[i + 1], NULL, 0);
+        } else if (!strcmp(argv[i], "--os")) {
+            unsigned t, p, h;
+            if (sscanf(argv[i + 1], "%u,%u,%u", &t, &p, &h) != 3 || t > 5 || p > 5 || h > 5) {
+                fprintf(stderr, "--os takes T,P,H register codes 0..5\n");
+                return 2;
+            }
+            cfg.os_t = (uint8_t)t;
+            cfg.os_p = (uint8_t)p;
+            cfg.os_h = (uint8_t)h;
+        } else if (!strcmp(argv[i], "--filter")) {
+            cfg.filter = (uint8_t)strtoul(argv[i + 1], NULL, 0);
+        } else if (!strcmp(argv[i], "--profiles")) {
+            count = parse_profiles(argv[i + 1], profiles);
+            if (!count) {
+                fprintf(stderr, "--profiles takes C:MS[,C:MS...]\n");
+                return 2;
+            }
+        } else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    static struct bme680_model model;
+    static struct bme680_raw dev;
+    static struct profile_result serial[BME680_SEQ_MAX_PROFILES], seq[BME680_SEQ_MAX_PROFILES];
+
+    bme680_model_init(&model);
+    bme680_model_set_env(&model, ENV_TEMP, ENV_PRESS, ENV_HUM, ENV_GAS);
+    sim_attach_bme680(ADDR, &model);
+
+    if (bme680_raw_init(&dev, &bus, ADDR) != 0 || bme680_raw_configure(&dev, &cfg) != 0) {
+        fprintf(stderr, "bme680 init failed\n");
+        return 1;
+    }
+
+    printf("os T/P/H codes %u/%u/%u, filter %u, %u rounds, bus %u kHz\n\n",
+           cfg.os_t, cfg.os_p, cfg.os_h, cfg.filter, n, SIM_I2C_HZ / 1000);
+
+    int rc = run_serial(&dev, profiles, count, n, serial);
+    if (rc == 0) rc = run_seq(&dev, profiles, count, n, seq);
+    if (rc) {
+        fprintf(stderr, "measurement failed: %d\n", rc);
+        return 1;
+    }
+
+    printf("\n%-7s %6s %7s %9s %8s %9s %7s %6s %7s\n", "mode", "heater", "time",
+           "meas/s", "txn/meas", "bus us", "dT [C]", "dP[Pa]", "dH [%]");
+    report("serial", profiles, count, serial);
+    report("seq", profiles, count, seq);
+    return 0;
+}
@@ -0,0 +1,12 @@
+#ifndef SIM_SHIM_ZEPHYR_DEVICE_H
+#define SIM_SHIM_ZEPHYR_DEVICE_H
+
+#include <stdbool.h>
+
+struct device {
+    const char *name;
+};
+
+static inline bool device_is_ready(const struct device *dev) { return dev != NULL; }
+
+#endif /* SIM_SHIM_ZEPHYR_DEVICE_H */
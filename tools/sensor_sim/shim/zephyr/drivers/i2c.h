@@ -0,0 +1,44 @@
+#ifndef SIM_SHIM_ZEPHYR_DRIVERS_I2C_H
+#define SIM_SHIM_ZEPHYR_DRIVERS_I2C_H
+
+/* Zephyr I2C helpers routed to the simulated bus (one bus per process) */
+
+#include <zephyr/device.h>
+#include <zephyr/kernel.h>
+
+#include "sim.h"
+
+static inline int i2c_write(const struct device *dev, const uint8_t *buf, uint32_t len,
+                            uint16_t addr)
+{
+    ARG_UNUSED(dev);
+    return sim_i2c_write(addr, buf, len);
+}
+
+static inline int i2c_write_read(const struct device *dev, uint16_t addr, const void *wbuf,
+                                 size_t wlen, void *rbuf, size_t rlen)
+{
+    ARG_UNUSED(dev);
+    return sim_i2c_write_read(addr, wbuf, (uint32_t)wlen, rbuf, (uint32_t)rlen);
+}
+
+static inline int i2c_burst_read(const struct device *dev, uint16_t addr, uint8_t start,
+                                 uint8_t *buf, uint32_t len)
+{
+    return i2c_write_read(dev, addr, &start, 1, buf, len);
+}
+
+static inline int i2c_reg_read_byte(const struct device *dev, uint16_t addr, uint8_t reg,
+                                    uint8_t *value)
+{
+    return i2c_write_read(dev, addr, &reg, 1, value, 1);
+}
+
+static inline int i2c_reg_write_byte(const struct device *dev, uint16_t addr, uint8_t reg,
+                                     uint8_t value)
+{
+    const uint8_t buf[2] = { reg, value };
+    return i2c_write(dev, buf, 2, addr);
+}
+
+#endif /* SIM_SHIM_ZEPHYR_DRIVERS_I2C_H */
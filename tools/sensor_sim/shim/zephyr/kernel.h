@@ -0,0 +1,34 @@
+#ifndef SIM_SHIM_ZEPHYR_KERNEL_H
+#define SIM_SHIM_ZEPHYR_KERNEL_H
+
+/* Host stand-in for the Zephyr kernel time APIs, on the sim clock (1 cycle = 1 us) */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sim.h"
+
+#define ARG_UNUSED(x) (void)(x)
+#define BIT(n)        (1UL << (n))
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
+
+typedef struct {
+    int64_t us;
+} k_timeout_t;
+
+#define K_NO_WAIT     ((k_timeout_t){ 0 })
+#define K_USEC(t)     ((k_timeout_t){ (int64_t)(t) })
+#define K_MSEC(t)     ((k_timeout_t){ (int64_t)(t) * 1000 })
+#define K_SECONDS(t)  ((k_timeout_t){ (int64_t)(t) * 1000000 })
+
+static inline int32_t k_usleep(int32_t us)      { sim_advance_us((uint64_t)us); return 0; }
+static inline int32_t k_msleep(int32_t ms)      { sim_advance_us((uint64_t)ms * 1000); return 0; }
+static inline int32_t k_sleep(k_timeout_t t)    { sim_advance_us((uint64_t)t.us); return 0; }
+static inline uint32_t k_uptime_get_32(void)    { return (uint32_t)(sim_now_us() / 1000); }
+static inline int64_t k_uptime_get(void)        { return (int64_t)(sim_now_us() / 1000); }
+static inline uint32_t k_cycle_get_32(void)     { return (uint32_t)sim_now_us(); }
+static inline uint32_t k_cyc_to_us_floor32(uint32_t cyc) { return cyc; }
+
+#endif /* SIM_SHIM_ZEPHYR_KERNEL_H */
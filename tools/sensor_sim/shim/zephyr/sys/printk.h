@@ -0,0 +1,8 @@
+#ifndef SIM_SHIM_ZEPHYR_SYS_PRINTK_H
+#define SIM_SHIM_ZEPHYR_SYS_PRINTK_H
+
+#include <stdio.h>
+
+#define printk printf
+
+#endif /* SIM_SHIM_ZEPHYR_SYS_PRINTK_H */
@@ -0,0 +1,89 @@
+#include <errno.h>
+#include <stddef.h>
+
+#include "sim.h"
+
+#define MAX_DEVICES 8
+
+static uint64_t now_us;
+
+static struct {
+    uint16_t addr;
+    struct bme680_model *model;
+} devices[MAX_DEVICES];
+static int device_count;
+
+static struct sim_bus_stats stats;
+
+uint64_t sim_now_us(void)
+{
+    return now_us;
+}
+
+void sim_advance_us(uint64_t us)
+{
+    now_us += us;
+}
+
+void sim_attach_bme680(uint16_t addr, struct bme680_model *m)
+{
+    if (device_count < MAX_DEVICES) {
+        devices[device_count].addr = addr;
+        devices[device_count].model = m;
+        device_count++;
+    }
+}
+
+void sim_bus_get_stats(struct sim_bus_stats *out)
+{
+    *out = stats;
+}
+
+void sim_bus_reset_stats(void)
+{
+    stats = (struct sim_bus_stats){ 0 };
+}
+
+static struct bme680_model *find(uint16_t addr)
+{
+    for (int i = 0; i < device_count; i++) {
+        if (devices[i].addr == addr) return devices[i].model;
+    }
+    return NULL;
+}
+
+/* 9 bits per byte plus start/stop; the caller blocks for the whole frame */
+static void bus_time(uint32_t bytes, uint32_t extra_bits)
+{
+    uint64_t bits = (uint64_t)bytes * 9 + extra_bits;
+    uint64_t us = (bits * 1000000 + SIM_I2C_HZ - 1) / SIM_I2C_HZ;
+
+    stats.transactions++;
+    stats.bytes += bytes;
+    stats.busy_us += us;
+    now_us += us;
+}
+
+int sim_i2c_write(uint16_t addr, const uint8_t *buf, uint32_t len)
+{
+    struct bme680_model *m = find(addr);
+
+    bus_time(1 + len, 2);
+    if (!m) return -EIO;
+
+    bme680_model_write(m, buf, len, now_us);
+    return 0;
+}
+
+int sim_i2c_write_read(uint16_t addr, const uint8_t *wbuf, uint32_t wlen,
+                       uint8_t *rbuf, uint32_t rlen)
+{
+    struct bme680_model *m = find(addr);
+
+    /* address + register, repeated start, address + data */
+    bus_time(2 + wlen + rlen, 3);
+    if (!m || wlen < 1) return -EIO;
+
+    bme680_model_read(m, wbuf[0], rbuf, rlen, now_us);
+    return 0;
+}
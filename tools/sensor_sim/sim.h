@@ -0,0 +1,35 @@
+#ifndef SIM_H
+#define SIM_H
+
+/*
+ * Host sensor simulation: a virtual clock and an I2C bus with BME680
+ * models attached. The Zephyr shims in shim/ route kernel time and I2C
+ * calls here, so the lab3/common sensor code runs unmodified.
+ */
+
+#include <stdint.h>
+
+#include "bme680_model.h"
+
+#define SIM_I2C_HZ 400000
+
+struct sim_bus_stats {
+    uint32_t transactions;
+    uint32_t bytes;         // address, register and data bytes on the wire
+    uint64_t busy_us;
+};
+
+uint64_t sim_now_us(void);
+void sim_advance_us(uint64_t us);
+
+void sim_attach_bme680(uint16_t addr, struct bme680_model *m);
+
+void sim_bus_get_stats(struct sim_bus_stats *out);
+void sim_bus_reset_stats(void);
+
+/* bus side, used by the I2C shim; return 0 or -EIO when nobody acks */
+int sim_i2c_write(uint16_t addr, const uint8_t *buf, uint32_t len);
+int sim_i2c_write_read(uint16_t addr, const uint8_t *wbuf, uint32_t wlen,
+                       uint8_t *rbuf, uint32_t rlen);
+
+#endif /* SIM_H */
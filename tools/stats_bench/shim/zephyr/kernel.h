@@ -0,0 +1,31 @@
+#ifndef STATS_BENCH_SHIM_ZEPHYR_KERNEL_H
+#define STATS_BENCH_SHIM_ZEPHYR_KERNEL_H
+
+/*
+ * Host stand-in for the Zephyr kernel APIs app_stats.c uses. The cycle
+ * counter is the monotonic clock in ns (1 cycle = 1 ns).
+ */
+
+#include <stdint.h>
+#include <time.h>
+
+#define ARG_UNUSED(x)   (void)(x)
+
+static inline uint64_t shim_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint32_t k_cycle_get_32(void)                 { return (uint32_t)shim_now_ns(); }
+static inline uint32_t k_cyc_to_us_floor32(uint32_t cyc)    { return cyc / 1000; }
+static inline uint64_t k_cyc_to_ns_floor64(uint64_t cyc)    { return cyc; }
+static inline uint32_t k_uptime_get_32(void)                { return (uint32_t)(shim_now_ns() / 1000000); }
+
+/* one host thread and no interrupts to mask */
+static inline unsigned int irq_lock(void)                   { return 0; }
+static inline void irq_unlock(unsigned int key)             { (void)key; }
+
+#endif /* STATS_BENCH_SHIM_ZEPHYR_KERNEL_H */
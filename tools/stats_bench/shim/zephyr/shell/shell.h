@@ -0,0 +1,26 @@
+#ifndef STATS_BENCH_SHIM_ZEPHYR_SHELL_SHELL_H
+#define STATS_BENCH_SHIM_ZEPHYR_SHELL_SHELL_H
+
+/* the "stats" commands compile, print to stdout, and are never registered */
+
+#include <stdio.h>
+
+#include <zephyr/sys/util.h>
+
+struct shell {
+    int unused;
+};
+
+#define shell_print(sh, fmt, ...)  ((void)(sh), printf(fmt "\n", ##__VA_ARGS__))
+#define shell_error(sh, fmt, ...)  ((void)(sh), printf(fmt "\n", ##__VA_ARGS__))
+
+#define SHELL_CMD(name, sub, help, handler)                 (handler)
+#define SHELL_CMD_ARG(name, sub, help, handler, req, opt)   (handler)
+#define SHELL_SUBCMD_SET_END                                NULL
+
+#define SHELL_STATIC_SUBCMD_SET_CREATE(name, ...) \
+    static void *const name[] __attribute__((unused)) = { __VA_ARGS__ }
+#define SHELL_CMD_REGISTER(name, sub, help, handler) \
+    extern int shell_cmd_##name##_unused
+
+#endif /* STATS_BENCH_SHIM_ZEPHYR_SHELL_SHELL_H */
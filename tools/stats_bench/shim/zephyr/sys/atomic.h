@@ -0,0 +1,22 @@
+#ifndef STATS_BENCH_SHIM_ZEPHYR_SYS_ATOMIC_H
+#define STATS_BENCH_SHIM_ZEPHYR_SYS_ATOMIC_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+
+/* 32-bit, as on the Cortex-M33 */
+typedef int32_t atomic_val_t;
+typedef _Atomic int32_t atomic_t;
+
+/* like Zephyr, inc/add return the previous value */
+static inline atomic_val_t atomic_inc(atomic_t *a)                  { return atomic_fetch_add(a, 1); }
+static inline atomic_val_t atomic_add(atomic_t *a, atomic_val_t v)  { return atomic_fetch_add(a, v); }
+static inline atomic_val_t atomic_get(const atomic_t *a)            { return atomic_load(a); }
+static inline atomic_val_t atomic_clear(atomic_t *a)                { return atomic_exchange(a, 0); }
+
+static inline bool atomic_cas(atomic_t *a, atomic_val_t old, atomic_val_t v)
+{
+    return atomic_compare_exchange_strong(a, &old, v);
+}
+
+#endif /* STATS_BENCH_SHIM_ZEPHYR_SYS_ATOMIC_H */
@@ -0,0 +1,24 @@
+#ifndef STATS_BENCH_SHIM_ZEPHYR_SYS_BYTEORDER_H
+#define STATS_BENCH_SHIM_ZEPHYR_SYS_BYTEORDER_H
+
+#include <stdint.h>
+
+static inline void sys_put_le16(uint16_t v, uint8_t *p)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void sys_put_le32(uint32_t v, uint8_t *p)
+{
+    sys_put_le16((uint16_t)v, p);
+    sys_put_le16((uint16_t)(v >> 16), p + 2);
+}
+
+static inline void sys_put_le64(uint64_t v, uint8_t *p)
+{
+    sys_put_le32((uint32_t)v, p);
+    sys_put_le32((uint32_t)(v >> 32), p + 4);
+}
+
+#endif /* STATS_BENCH_SHIM_ZEPHYR_SYS_BYTEORDER_H */
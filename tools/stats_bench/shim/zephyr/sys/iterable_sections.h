@@ -0,0 +1,12 @@
+#ifndef STATS_BENCH_SHIM_ZEPHYR_SYS_ITERABLE_SECTIONS_H
+#define STATS_BENCH_SHIM_ZEPHYR_SYS_ITERABLE_SECTIONS_H
+
+/* the linker provides __start_/__stop_ for sections named like identifiers */
+#define STRUCT_SECTION_ITERABLE(type, var) \
+    struct type var __attribute__((section("_" #type "_list"), used, aligned(8)))
+
+#define STRUCT_SECTION_FOREACH(type, var)                                       \
+    extern struct type __start__##type##_list[], __stop__##type##_list[];       \
+    for (struct type *var = __start__##type##_list; var < __stop__##type##_list; var++)
+
+#endif /* STATS_BENCH_SHIM_ZEPHYR_SYS_ITERABLE_SECTIONS_H */
@@ -0,0 +1,7 @@
+#ifndef STATS_BENCH_SHIM_ZEPHYR_SYS_UTIL_H
+#define STATS_BENCH_SHIM_ZEPHYR_SYS_UTIL_H
+
+#define MIN(a, b)       ((a) < (b) ? (a) : (b))
+#define ARRAY_SIZE(a)   (sizeof(a) / sizeof((a)[0]))
+
+#endif /* STATS_BENCH_SHIM_ZEPHYR_SYS_UTIL_H */
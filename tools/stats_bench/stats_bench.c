@@ -0,0 +1,152 @@
+/*
+ * common/app_stats.c on the host.
+ *
+ *   stats_bench
+ *
+ * app_stats.c runs unmodified against the shim in shim/ (C11 atomics,
+ * 32-bit like the board's). It checks the histogram and dump layout,
+ * then prints what "stats bench" measures, as measured on this host.
+ *
+ * Checks (exit status 1 on any failure):
+ *   - a 200 ms period in us, recorded past 2^32 of sum: the sum and
+ *     average stay exact, every sample in bucket 18
+ *   - values up to 2^32 - 1 land in buckets 30 and 31
+ *   - the dump carries the same count, 64-bit sum, max and 32 buckets
+ *   - reset zeroes every statistic
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "app_stats.h"
+
+APP_STAT_COUNTER_DEFINE(st_ticks, "bench.ticks");
+APP_STAT_HIST_DEFINE(st_period, "bench.period", "us");
+APP_STAT_HIST_DEFINE(st_wide, "bench.wide", "us");
+
+static unsigned failures;
+
+static void check(bool ok, const char *what)
+{
+    if (!ok) {
+        printf("  FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+static uint32_t get32(const uint8_t *p)
+{
+    return p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+/* ===================== Checks ===================== */
+static void long_period(void)
+{
+    const uint32_t period_us = 200000, n = 30000;   // 100 min of blink.period
+
+    for (uint32_t i = 0; i < n; i++) {
+        app_stat_hist_record(&st_period, period_us);
+        app_stat_inc(&st_ticks);
+    }
+
+    uint64_t sum = app_stat_hist_sum(&st_period);
+
+    printf("period: n %u sum %llu avg %llu\n", n, (unsigned long long)sum,
+           (unsigned long long)(sum / n));
+    check(sum == (uint64_t)period_us * n, "period: sum wrapped");
+    check((uint32_t)atomic_get(&st_period_hist.bucket[18]) == n, "period: not in bucket 18");
+    check((uint32_t)atomic_get(&st_period_hist.max) == period_us, "period: max");
+}
+
+static void wide_values(void)
+{
+    app_stat_hist_record(&st_wide, 1u << 29);
+    app_stat_hist_record(&st_wide, 1u << 30);
+    app_stat_hist_record(&st_wide, UINT32_MAX);
+
+    check(atomic_get(&st_wide_hist.bucket[30]) == 1, "wide: 2^29 not in bucket 30");
+    check(atomic_get(&st_wide_hist.bucket[31]) == 2, "wide: 2^30 and 2^32-1 not in bucket 31");
+    check(app_stat_hist_sum(&st_wide) == (1ull << 29) + (1ull << 30) + UINT32_MAX, "wide: sum");
+    check((uint32_t)atomic_get(&st_wide_hist.max) == UINT32_MAX, "wide: max");
+}
+
+static void dump(void)
+{
+    static uint8_t buf[1024];
+    size_t n = app_stats_dump(buf, sizeof(buf));
+
+    check(n <= sizeof(buf), "dump: does not fit");
+    check(memcmp(buf, "ASTD", 4) == 0 && buf[4] == 2, "dump: header");
+    check((buf[6] | buf[7] << 8) == 3, "dump: entry count");
+
+    bool seen = false;
+    const uint8_t *p = buf + 12;
+
+    for (int e = 0; e < 3 && p < buf + n; e++) {
+        uint8_t type = p[0], len = p[1];
+        bool period = len == strlen("bench.period") && memcmp(p + 2, "bench.period", len) == 0;
+
+        p += 2 + len;
+        uint32_t count = get32(p);
+        p += 4;
+        if (type != APP_STAT_HIST) continue;
+
+        uint64_t sum = get32(p) | (uint64_t)get32(p + 4) << 32;
+        uint32_t max = get32(p + 8);
+        const uint8_t *bucket = p + 12;
+
+        p += 12 + 4 * APP_STAT_HIST_BUCKETS;
+        if (!period) continue;
+
+        seen = true;
+        check(count == 30000 && sum == 6000000000ull && max == 200000, "dump: period values");
+        check(get32(bucket + 4 * 18) == 30000, "dump: period bucket 18");
+    }
+    check(seen, "dump: bench.period missing");
+    check(p == buf + n, "dump: length");
+}
+
+static void reset(void)
+{
+    app_stats_reset();
+    check(atomic_get(&st_ticks.value) == 0, "reset: counter");
+    check(atomic_get(&st_period.value) == 0 && app_stat_hist_sum(&st_period) == 0 &&
+          atomic_get(&st_period_hist.bucket[18]) == 0 && atomic_get(&st_period_hist.max) == 0,
+          "reset: histogram");
+}
+
+/* ===================== Bench ===================== */
+static void bench(void)
+{
+    uint32_t ns_x10[APP_STATS_BENCH_OPS];
+
+    /* best of a few runs, as the host is not otherwise idle */
+    for (int run = 0; run < 5; run++) {
+        uint32_t r[APP_STATS_BENCH_OPS];
+
+        app_stats_bench(r);
+        for (int i = 0; i < APP_STATS_BENCH_OPS; i++) {
+            if (run == 0 || r[i] < ns_x10[i]) ns_x10[i] = r[i];
+        }
+    }
+
+    printf("\nstats bench on this host:\n");
+    for (int i = 0; i < APP_STATS_BENCH_OPS; i++) {
+        printf("%-12s %u.%u ns per update\n", app_stats_bench_name[i], ns_x10[i] / 10,
+               ns_x10[i] % 10);
+    }
+}
+
+int main(void)
+{
+    long_period();
+    wide_values();
+    dump();
+    reset();
+    bench();
+
+    printf("\n%s: %u failed check%s\n", failures ? "FAIL" : "PASS", failures,
+           failures == 1 ? "" : "s");
+    return failures ? 1 : 0;
+}